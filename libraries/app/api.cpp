@@ -26,6 +26,7 @@
 #include <graphene/app/api.hpp>
 #include <graphene/app/api_access.hpp>
 #include <graphene/app/application.hpp>
+#include <graphene/account_history/account_history_plugin.hpp>
 #include <graphene/chain/confidential_object.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/get_config.hpp>
@@ -42,6 +43,7 @@
 #include <fc/thread/future.hpp>
 
 template class fc::api<graphene::app::block_api>;
+template class fc::api<graphene::app::profiler_api>;
 template class fc::api<graphene::app::network_broadcast_api>;
 template class fc::api<graphene::app::network_node_api>;
 template class fc::api<graphene::app::history_api>;
@@ -80,9 +82,11 @@ bool login_api::login(const string &user, const string &password) {
 
 void login_api::enable_api(const std::string &api_name) {
    if (api_name == "database_api") {
-      _database_api = std::make_shared<database_api>(std::ref(*_app.chain_database()));
+      _database_api = std::make_shared<database_api>(std::ref(*_app.chain_database()), &_app);
    } else if (api_name == "block_api") {
       _block_api = std::make_shared<block_api>(std::ref(*_app.chain_database()));
+   } else if (api_name == "profiler_api") {
+      _profiler_api = std::make_shared<profiler_api>(std::ref(*_app.chain_database()));
    } else if (api_name == "network_broadcast_api") {
       _network_broadcast_api = std::make_shared<network_broadcast_api>(std::ref(_app));
    } else if (api_name == "history_api") {
@@ -127,6 +131,17 @@ vector<optional<signed_block>> block_api::get_blocks(uint32_t block_num_from, ui
    return res;
 }
 
+// profiler_api
+profiler_api::profiler_api(graphene::chain::database &db) :
+      _db(db) {
+}
+profiler_api::~profiler_api() {
+}
+
+optional<block_profile> profiler_api::get_block_profile(bool reset) const {
+   return _db.get_block_profile(reset);
+}
+
 network_broadcast_api::network_broadcast_api(application &a) :
       _app(a) {
    _applied_block_connection = _app.chain_database()->applied_block.connect([this](const signed_block &b) {
@@ -311,6 +326,11 @@ fc::api<graphene::peerplays_sidechain::sidechain_api> login_api::sidechain() con
    return *_sidechain_api;
 }
 
+fc::api<profiler_api> login_api::profiler() const {
+   FC_ASSERT(_profiler_api);
+   return *_profiler_api;
+}
+
 vector<order_history_object> history_api::get_fill_order_history(std::string asset_a, std::string asset_b, uint32_t limit) const {
    FC_ASSERT(_app.chain_database());
    const auto &db = *_app.chain_database();
@@ -395,12 +415,35 @@ vector<operation_history_object> history_api::get_account_history_operations(con
                                                                              operation_history_id_type start,
                                                                              operation_history_id_type stop,
                                                                              unsigned limit) const {
-   FC_ASSERT(_app.chain_database());
-   const auto &db = *_app.chain_database();
    FC_ASSERT(limit <= api_limit_get_account_history_operations,
              "Number of querying history accounts can not be greater than ${configured_limit}",
              ("configured_limit", api_limit_get_account_history_operations));
 
+   flat_set<int> operation_types;
+   operation_types.insert(operation_id);
+   return get_account_history_by_operation_types(account_id_or_name, operation_types, start, stop, limit);
+}
+
+vector<operation_history_object> history_api::get_account_history_by_operations(const std::string account_id_or_name,
+                                                                                const flat_set<int> &operation_types,
+                                                                                operation_history_id_type start,
+                                                                                operation_history_id_type stop,
+                                                                                unsigned limit) const {
+   FC_ASSERT(limit <= api_limit_get_account_history_operations,
+             "Number of querying history accounts can not be greater than ${configured_limit}",
+             ("configured_limit", api_limit_get_account_history_operations));
+
+   return get_account_history_by_operation_types(account_id_or_name, operation_types, start, stop, limit);
+}
+
+vector<operation_history_object> history_api::get_account_history_by_operation_types(const std::string &account_id_or_name,
+                                                                                     const flat_set<int> &operation_types,
+                                                                                     operation_history_id_type start,
+                                                                                     operation_history_id_type stop,
+                                                                                     unsigned limit) const {
+   FC_ASSERT(_app.chain_database());
+   const auto &db = *_app.chain_database();
+
    vector<operation_history_object> result;
    account_id_type account;
    try {
@@ -409,6 +452,13 @@ vector<operation_history_object> history_api::get_account_history_operations(con
       return result;
    }
 
+   auto ah = _app.get_plugin<account_history::account_history_plugin>("account_history");
+   if (ah && ah->operation_type_index() != nullptr) {
+      for (const auto &op_id : ah->operation_type_index()->get_operations(account, operation_types, start, stop, limit))
+         result.push_back(op_id(db));
+      return result;
+   }
+
    const auto &stats = account(db).statistics(db);
    if (stats.most_recent_op == account_transaction_history_id_type())
       return result;
@@ -418,9 +468,9 @@ vector<operation_history_object> history_api::get_account_history_operations(con
 
    while (node && node->operation_id.instance.value > stop.instance.value && result.size() < limit) {
       if (node->operation_id.instance.value <= start.instance.value) {
-
-         if (node->operation_id(db).op.which() == operation_id)
-            result.push_back(node->operation_id(db));
+         const auto &oho = node->operation_id(db);
+         if (operation_types.count(oho.op.which()))
+            result.push_back(oho);
       }
       if (node->next == account_transaction_history_id_type())
          node = nullptr;
@@ -429,7 +479,7 @@ vector<operation_history_object> history_api::get_account_history_operations(con
    }
    if (stop.instance.value == 0 && result.size() < limit) {
       auto head = db.find(account_transaction_history_id_type());
-      if (head != nullptr && head->account == account && head->operation_id(db).op.which() == operation_id)
+      if (head != nullptr && head->account == account && operation_types.count(head->operation_id(db).op.which()))
          result.push_back(head->operation_id(db));
    }
    return result;
@@ -524,6 +574,24 @@ asset_api::asset_api(graphene::app::application &app) :
 asset_api::~asset_api() {
 }
 
+/**
+ * Balances of an asset are ranked from the largest, so its holders are the entries before the first zero balance
+ * @return the range of account balances with a non-zero amount of the asset
+ */
+static std::pair<account_balance_object_multi_index_type::index<by_asset_balance>::type::const_iterator,
+                 account_balance_object_multi_index_type::index<by_asset_balance>::type::const_iterator>
+asset_holders_range(const graphene::chain::database &db, asset_id_type asset_id) {
+   const auto &bal_idx = db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
+   return std::make_pair(bal_idx.lower_bound(boost::make_tuple(asset_id)),
+                         bal_idx.lower_bound(boost::make_tuple(asset_id, share_type(0))));
+}
+
+static uint32_t asset_holders_count(const graphene::chain::database &db, asset_id_type asset_id) {
+   const auto &bal_idx = db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
+   auto range = asset_holders_range(db, asset_id);
+   return bal_idx.rank(range.second) - bal_idx.rank(range.first);
+}
+
 vector<account_asset_balance> asset_api::get_asset_holders(std::string asset, uint32_t start, uint32_t limit) const {
    FC_ASSERT(limit <= api_limit_get_asset_holders,
              "Number of querying asset holder accounts can not be greater than ${configured_limit}",
@@ -531,27 +599,19 @@ vector<account_asset_balance> asset_api::get_asset_holders(std::string asset, ui
 
    asset_id_type asset_id = database_api.get_asset_id_from_string(asset);
    const auto &bal_idx = _db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
-   auto range = bal_idx.equal_range(boost::make_tuple(asset_id));
+   auto range = asset_holders_range(_db, asset_id);
 
    vector<account_asset_balance> result;
+   if (start >= bal_idx.rank(range.second) - bal_idx.rank(range.first))
+      return result;
 
-   uint32_t index = 0;
-   for (const account_balance_object &bal : boost::make_iterator_range(range.first, range.second)) {
-      if (result.size() >= limit)
-         break;
-
-      if (bal.balance.value == 0)
-         continue;
-
-      if (index++ < start)
-         continue;
-
-      const auto account = _db.find(bal.owner);
+   for (auto itr = bal_idx.nth(bal_idx.rank(range.first) + start); itr != range.second && result.size() < limit; ++itr) {
+      const auto account = _db.find(itr->owner);
 
       account_asset_balance aab;
       aab.name = account->name;
       aab.account_id = account->id;
-      aab.amount = bal.balance.value;
+      aab.amount = itr->balance.value;
 
       result.push_back(aab);
    }
@@ -560,39 +620,25 @@ vector<account_asset_balance> asset_api::get_asset_holders(std::string asset, ui
 }
 // get number of asset holders.
 int asset_api::get_asset_holders_count(std::string asset) const {
-
-   const auto &bal_idx = _db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
    asset_id_type asset_id = database_api.get_asset_id_from_string(asset);
-   auto range = bal_idx.equal_range(boost::make_tuple(asset_id));
-   int count = boost::distance(range) - 1;
-
-   return count;
+   return asset_holders_count(_db, asset_id);
 }
 // function to get vector of system assets with holders count.
 vector<asset_holders> asset_api::get_all_asset_holders() const {
+   auto db = _app.chain_database();
+   return _app.run_read_only_api_call([db]() {
+      vector<asset_holders> result;
 
-   vector<asset_holders> result;
-
-   vector<asset_id_type> total_assets;
-   for (const asset_object &asset_obj : _db.get_index_type<asset_index>().indices()) {
-      const auto &dasset_obj = asset_obj.dynamic_asset_data_id(_db);
-
-      asset_id_type asset_id;
-      asset_id = dasset_obj.id;
-
-      const auto &bal_idx = _db.get_index_type<account_balance_index>().indices().get<by_asset_balance>();
-      auto range = bal_idx.equal_range(boost::make_tuple(asset_id));
-
-      int count = boost::distance(range) - 1;
+      for (const asset_object &asset_obj : db->get_index_type<asset_index>().indices()) {
+         asset_holders ah;
+         ah.asset_id = asset_obj.id;
+         ah.count = asset_holders_count(*db, asset_obj.id);
 
-      asset_holders ah;
-      ah.asset_id = asset_id;
-      ah.count = count;
-
-      result.push_back(ah);
-   }
+         result.push_back(ah);
+      }
 
-   return result;
+      return result;
+   });
 }
 
 }} // namespace graphene::app
@@ -25,6 +25,7 @@
 #include <graphene/app/api_access.hpp>
 #include <graphene/app/application.hpp>
 #include <graphene/app/plugin.hpp>
+#include <graphene/app/subscription_hub.hpp>
 
 #include <graphene/chain/protocol/fee_schedule.hpp>
 #include <graphene/chain/protocol/types.hpp>
@@ -214,6 +215,17 @@ public:
       login->login(username, password);
    }
 
+   void reset_api_threads() {
+      _api_threads.clear();
+      const uint16_t thread_count = _options->count("api-threads") ? _options->at("api-threads").as<uint16_t>() : 0;
+      for (uint16_t i = 0; i < thread_count; ++i)
+         _api_threads.push_back(std::make_shared<fc::thread>("api " + std::to_string(i)));
+      if (_options->count("api-call-timeout"))
+         _api_call_timeout = fc::milliseconds(_options->at("api-call-timeout").as<uint32_t>());
+      if (thread_count > 0)
+         ilog("Running read-only API calls on ${n} threads", ("n", thread_count));
+   }
+
    void reset_websocket_server() {
       try {
          if (!_options->count("rpc-endpoint"))
@@ -251,10 +263,14 @@ public:
 
    explicit application_impl(application *self) :
          _self(self),
-         _chain_db(std::make_shared<chain::database>()) {
+         _chain_db(std::make_shared<chain::database>()),
+         _subscription_hub(std::make_shared<subscription_hub>(*_chain_db)) {
    }
 
    ~application_impl() {
+      // precomputation tasks still reference the prefetched blocks
+      for (auto &prefetched : _prefetched_blocks)
+         prefetched.second.precomputed.wait();
    }
 
    void set_dbg_init_key(genesis_state_type &genesis, const std::string &init_key) {
@@ -324,6 +340,10 @@ public:
             _chain_db->enable_standby_votes_tracking(_options->at("enable-standby-votes-tracking").as<bool>());
          }
 
+         if (_options->count("block-profiling") && _options->at("block-profiling").as<bool>()) {
+            _chain_db->enable_block_profiling(true, _options->at("block-profiling-log-interval").as<uint32_t>());
+         }
+
          std::string replay_reason = "reason not provided";
 
          if (_options->count("replay-blockchain"))
@@ -368,6 +388,7 @@ public:
             _apiaccess.permission_map["*"] = wild_access;
          }
 
+         reset_api_threads();
          reset_p2p_node(_data_dir);
          reset_websocket_server();
          reset_websocket_tls_server();
@@ -436,7 +457,17 @@ public:
             // you can help the network code out by throwing a block_older_than_undo_history exception.
             // when the net code sees that, it will stop trying to push blocks from that chain, but
             // leave that peer connected so that they can get sync blocks from us
-            bool result = _chain_db->push_block(blk_msg.block, (_is_block_producer | _force_validate) ? database::skip_nothing : database::skip_transaction_signatures);
+            const uint32_t skip = (_is_block_producer | _force_validate) ? database::skip_nothing : database::skip_transaction_signatures;
+            std::shared_ptr<const signed_block> prefetched_block;
+            auto prefetched = _prefetched_blocks.find(blk_msg.block_id);
+            if (prefetched != _prefetched_blocks.end()) {
+               prefetched->second.precomputed.wait();
+               prefetched_block = prefetched->second.block;
+               _prefetched_blocks.erase(prefetched);
+            } else
+               _chain_db->precompute_parallel(blk_msg.block, skip).wait();
+
+            bool result = _chain_db->push_block(prefetched_block ? *prefetched_block : blk_msg.block, skip);
 
             // the block was accepted, so we now know all of the transactions contained in the block
             if (!sync_mode) {
@@ -445,10 +476,9 @@ public:
                // happens, there's no reason to fetch the transactions, so  construct a list of the
                // transaction message ids we no longer need.
                // during sync, it is unlikely that we'll see any old
-               for (const processed_transaction &transaction : blk_msg.block.transactions) {
-                  graphene::net::trx_message transaction_message(transaction);
-                  contained_transaction_message_ids.push_back(graphene::net::message(transaction_message).id());
-               }
+               contained_transaction_message_ids.reserve(blk_msg.block.transactions.size());
+               for (const processed_transaction &transaction : blk_msg.block.transactions)
+                  contained_transaction_message_ids.push_back(graphene::net::get_trx_message_id(transaction));
             }
 
             return result;
@@ -469,6 +499,34 @@ public:
       FC_CAPTURE_AND_RETHROW((blk_msg)(sync_mode))
    }
 
+   /**
+       * @brief starts precomputing transaction ids and signatures of a sync block in the background
+       *
+       * The block is copied so that the network code is free to move its message around while
+       * the worker threads fill the cached fields; handle_block() then pushes the copy.
+       */
+   virtual void prefetch_block(const graphene::net::block_message &blk_msg) override {
+      if (!_running.load() || _prefetched_blocks.count(blk_msg.block_id))
+         return;
+
+      // forget blocks which were never handled, e.g. because the peer sending them was dropped
+      const uint32_t head_num = _chain_db->head_block_num();
+      for (auto itr = _prefetched_blocks.begin(); itr != _prefetched_blocks.end();) {
+         if (block_header::num_from_id(itr->first) <= head_num) {
+            itr->second.precomputed.wait();
+            itr = _prefetched_blocks.erase(itr);
+         } else
+            ++itr;
+      }
+      if (_prefetched_blocks.size() >= _max_prefetched_blocks)
+         return;
+
+      const uint32_t skip = (_is_block_producer | _force_validate) ? database::skip_nothing : database::skip_transaction_signatures;
+      prefetched_block_info &info = _prefetched_blocks[blk_msg.block_id];
+      info.block = std::make_shared<const signed_block>(blk_msg.block);
+      info.precomputed = _chain_db->precompute_parallel(*info.block, skip);
+   }
+
    virtual void handle_transaction(const graphene::net::trx_message &transaction_message) override {
       try {
          static fc::time_point last_call;
@@ -486,6 +544,44 @@ public:
       FC_CAPTURE_AND_RETHROW((transaction_message))
    }
 
+   /**
+       * @brief checks a batch of transactions from the network in parallel, then pushes them in order
+       *
+       * Validation, expiration checks and signature recovery run on the database's worker threads
+       * while this fc thread keeps serving its other tasks; only authority checks and evaluation
+       * are left for push_transaction().
+       */
+   virtual std::vector<fc::oexception> handle_transactions(const std::vector<graphene::net::trx_message> &transaction_messages) override {
+      static fc::time_point last_call;
+      static int trx_count = 0;
+      trx_count += transaction_messages.size();
+      auto now = fc::time_point::now();
+      if (now - last_call > fc::seconds(1)) {
+         ilog("Got ${c} transactions from network", ("c", trx_count));
+         last_call = now;
+         trx_count = 0;
+      }
+
+      std::vector<signed_transaction> transactions;
+      transactions.reserve(transaction_messages.size());
+      for (const graphene::net::trx_message &transaction_message : transaction_messages)
+         transactions.push_back(transaction_message.trx);
+
+      std::vector<fc::oexception> results;
+      _chain_db->precheck_transactions_parallel(transactions, results).wait();
+
+      for (size_t i = 0; i < transactions.size(); ++i) {
+         if (results[i])
+            continue;
+         try {
+            _chain_db->push_transaction(transactions[i]);
+         } catch (const fc::exception &e) {
+            results[i] = e;
+         }
+      }
+      return results;
+   }
+
    virtual void handle_message(const message &message_to_process) override {
       // not a transaction, not a block
       FC_THROW("Invalid Message Type");
@@ -805,6 +901,7 @@ public:
    api_access _apiaccess;
 
    std::shared_ptr<graphene::chain::database> _chain_db;
+   std::shared_ptr<subscription_hub> _subscription_hub;
    std::shared_ptr<graphene::net::node> _p2p_network;
    std::shared_ptr<fc::http::websocket_server> _websocket_server;
    std::shared_ptr<fc::http::websocket_tls_server> _websocket_tls_server;
@@ -813,6 +910,19 @@ public:
    std::map<string, std::shared_ptr<abstract_plugin>> _available_plugins;
 
    bool _is_finished_syncing = false;
+
+   /// Threads running read-only API calls, see application::run_read_only_api_call()
+   std::vector<std::shared_ptr<fc::thread>> _api_threads;
+   std::atomic<uint32_t> _next_api_thread{0};
+   fc::microseconds _api_call_timeout = fc::seconds(10);
+
+   struct prefetched_block_info {
+      std::shared_ptr<const signed_block> block;
+      std::future<void> precomputed;
+   };
+   /// Sync blocks whose transactions are being precomputed, see prefetch_block()
+   std::map<block_id_type, prefetched_block_info> _prefetched_blocks;
+   static constexpr size_t _max_prefetched_blocks = 1000;
 };
 
 } // namespace detail
@@ -862,6 +972,15 @@ void application::set_program_options(boost::program_options::options_descriptio
    cfg.add_options()("enable-standby-votes-tracking", bpo::value<bool>()->implicit_value(true),
                      "Whether to enable tracking of votes of standby witnesses and committee members. "
                      "Set it to true to provide accurate data to API clients, set to false for slightly better performance.");
+   cfg.add_options()("block-profiling", bpo::value<bool>()->implicit_value(true),
+                     "Whether to record per-phase and per-operation timing of block application, see profiler_api.");
+   cfg.add_options()("block-profiling-log-interval", bpo::value<uint32_t>()->default_value(1200),
+                     "Dump the block profile to the log every this many blocks, 0 to disable.");
+   cfg.add_options()("api-threads", bpo::value<uint16_t>()->default_value(0),
+                     "Number of threads running expensive read-only API calls concurrently with block processing, "
+                     "0 to run them on the main thread.");
+   cfg.add_options()("api-call-timeout", bpo::value<uint32_t>()->default_value(10000),
+                     "Milliseconds after which a read-only API call running on an API thread fails.");
    cfg.add_options()("plugins", bpo::value<string>()->default_value("account_history accounts_list affiliate_stats bookie market_history witness"),
                      "Space-separated list of plugins to activate");
 
@@ -965,6 +1084,20 @@ std::shared_ptr<chain::database> application::chain_database() const {
    return my->_chain_db;
 }
 
+std::shared_ptr<subscription_hub> application::get_subscription_hub() const {
+   return my->_subscription_hub;
+}
+
+fc::thread *application::next_api_thread() const {
+   if (my->_api_threads.empty())
+      return nullptr;
+   return my->_api_threads[my->_next_api_thread++ % my->_api_threads.size()].get();
+}
+
+fc::microseconds application::api_call_timeout() const {
+   return my->_api_call_timeout;
+}
+
 void application::set_block_production(bool producing_blocks) {
    my->_is_block_producer = producing_blocks;
 }
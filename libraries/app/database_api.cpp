@@ -22,7 +22,9 @@
  * THE SOFTWARE.
  */
 
+#include <graphene/app/application.hpp>
 #include <graphene/app/database_api.hpp>
+#include <graphene/app/subscription_hub.hpp>
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/get_config.hpp>
 #include <graphene/chain/protocol/address.hpp>
@@ -82,9 +84,9 @@ signed_block_with_info::signed_block_with_info(const signed_block &block) :
       transaction_ids.push_back(tx.id());
 }
 
-class database_api_impl : public std::enable_shared_from_this<database_api_impl> {
+class database_api_impl : public std::enable_shared_from_this<database_api_impl>, public object_update_subscriber {
 public:
-   database_api_impl(graphene::chain::database &db);
+   database_api_impl(graphene::chain::database &db, const application *app);
    ~database_api_impl();
 
    // Objects
@@ -175,6 +177,7 @@ public:
    market_volume get_24_volume(const string &base, const string &quote) const;
    order_book get_order_book(const string &base, const string &quote, unsigned limit = 50) const;
    vector<market_trade> get_trade_history(const string &base, const string &quote, fc::time_point_sec start, fc::time_point_sec stop, unsigned limit = 100) const;
+   vector<market_trade> get_trade_history_by_sequence(const string &base, const string &quote, int64_t start, fc::time_point_sec stop, unsigned limit = 100) const;
 
    // Witnesses
    vector<optional<witness_object>> get_witnesses(const vector<witness_id_type> &witness_ids) const;
@@ -314,23 +317,34 @@ public:
    uint32_t api_limit_get_trade_history_by_sequence = 100;
 
    //private:
+   market_trade make_market_trade(const order_history_object &history, const vector<optional<asset_object>> &assets) const;
    const account_object *get_account_from_string(const std::string &name_or_id,
                                                  bool throw_if_not_found = true) const;
    const asset_object *get_asset_from_string(const std::string &symbol_or_id,
                                              bool throw_if_not_found = true) const;
+   /// Runs an expensive query on an API thread if the application provides them
+   template <typename Lambda>
+   auto run_read_only(Lambda callback) const -> decltype(callback()) {
+      if (_app == nullptr)
+         return callback();
+      return _app->run_read_only_api_call(callback);
+   }
+
    template <typename T>
    void subscribe_to_item(const T &i) const {
       auto vec = fc::raw::pack(i);
+      const std::lock_guard<std::mutex> subscribe_lock{_subscribe_mutex};
       if (!_subscribe_callback)
          return;
 
-      if (!is_subscribed_to_item(i)) {
+      if (!_subscribe_filter.contains(i)) {
          _subscribe_filter.insert(vec.data(), vec.size()); //(vecconst char*)&i, sizeof(i) );
       }
    }
 
    template <typename T>
    bool is_subscribed_to_item(const T &i) const {
+      const std::lock_guard<std::mutex> subscribe_lock{_subscribe_mutex};
       if (!_subscribe_callback)
          return false;
 
@@ -338,6 +352,7 @@ public:
    }
 
    bool is_impacted_account(const flat_set<account_id_type> &accounts) {
+      const std::lock_guard<std::mutex> subscribe_lock{_subscribe_mutex};
       if (!_subscribed_accounts.size() || !accounts.size())
          return false;
 
@@ -347,42 +362,48 @@ public:
    }
 
    template <typename T>
-   void enqueue_if_subscribed_to_market(const object *obj, market_queue_type &queue, bool full_object = true) {
-      const T *order = dynamic_cast<const T *>(obj);
+   void enqueue_if_subscribed_to_market(const object_update_batch &batch, object_id_type id, market_queue_type &queue, bool full_object = true) {
+      const T *order = dynamic_cast<const T *>(batch.find(id));
       FC_ASSERT(order != nullptr);
 
       auto market = order->get_market();
 
       auto sub = _market_subscriptions.find(market);
       if (sub != _market_subscriptions.end()) {
-         queue[market].emplace_back(full_object ? obj->to_variant() : fc::variant(obj->id, 1));
+         queue[market].emplace_back(full_object ? batch.to_variant(id) : fc::variant(id, 1));
       }
    }
 
-   void broadcast_updates(const vector<variant> &updates);
+   void broadcast_updates(const vector<std::pair<object_id_type, variant>> &updates);
+   void send_pending_updates();
    void broadcast_market_updates(const market_queue_type &queue);
-   void handle_object_changed(bool force_notify, bool full_object, const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts, std::function<const object *(object_id_type id)> find_object);
+   void handle_object_changed(bool force_notify, bool full_object, const object_update_batch &batch);
 
    /** called every time a block is applied to report the objects that were changed */
-   void on_objects_new(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts);
-   void on_objects_changed(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts);
-   void on_objects_removed(const vector<object_id_type> &ids, const vector<const object *> &objs, const flat_set<account_id_type> &impacted_accounts);
+   void on_objects_new(const object_update_batch &batch) override;
+   void on_objects_changed(const object_update_batch &batch) override;
+   void on_objects_removed(const object_update_batch &batch) override;
    void on_applied_block();
 
    bool _notify_remove_create = false;
+   /// guards the subscriptions, which queries running on API threads may add to
+   mutable std::mutex _subscribe_mutex;
    mutable fc::bloom_filter _subscribe_filter;
    std::set<account_id_type> _subscribed_accounts;
    std::function<void(const fc::variant &)> _subscribe_callback;
+   /// updates waiting for the callback, at most one per object, sent by a single task at a time
+   vector<variant> _pending_updates;
+   std::unordered_map<object_id_type, size_t> _pending_update_positions;
+   bool _sending_updates = false;
    std::function<void(const fc::variant &)> _pending_trx_callback;
    std::function<void(const fc::variant &)> _block_applied_callback;
 
-   boost::signals2::scoped_connection _new_connection;
-   boost::signals2::scoped_connection _change_connection;
-   boost::signals2::scoped_connection _removed_connection;
+   std::shared_ptr<subscription_hub> _subscription_hub;
    boost::signals2::scoped_connection _applied_block_connection;
    boost::signals2::scoped_connection _pending_trx_connection;
    map<pair<asset_id_type, asset_id_type>, std::function<void(const variant &)>> _market_subscriptions;
    graphene::chain::database &_db;
+   const application *_app = nullptr;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -391,25 +412,20 @@ public:
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-database_api::database_api(graphene::chain::database &db) :
-      my(new database_api_impl(db)) {
+database_api::database_api(graphene::chain::database &db, const application *app) :
+      my(new database_api_impl(db, app)) {
+   my->_subscription_hub->subscribe(my);
 }
 
 database_api::~database_api() {
 }
 
-database_api_impl::database_api_impl(graphene::chain::database &db) :
-      _db(db) {
+database_api_impl::database_api_impl(graphene::chain::database &db, const application *app) :
+      _db(db),
+      _app(app) {
    wlog("creating database api ${x}", ("x", int64_t(this)));
-   _new_connection = _db.new_objects.connect([this](const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
-      on_objects_new(ids, impacted_accounts);
-   });
-   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
-      on_objects_changed(ids, impacted_accounts);
-   });
-   _removed_connection = _db.removed_objects.connect([this](const vector<object_id_type> &ids, const vector<const object *> &objs, const flat_set<account_id_type> &impacted_accounts) {
-      on_objects_removed(ids, objs, impacted_accounts);
-   });
+   // connections of an application share its hub, so that changed objects are serialized once for all of them
+   _subscription_hub = _app != nullptr ? _app->get_subscription_hub() : std::make_shared<subscription_hub>(_db);
    _applied_block_connection = _db.applied_block.connect([this](const signed_block &) {
       on_applied_block();
    });
@@ -471,7 +487,10 @@ void database_api::set_subscribe_callback(std::function<void(const variant &)> c
 
 void database_api_impl::set_subscribe_callback(std::function<void(const variant &)> cb, bool notify_remove_create) {
    //edump((clear_filter));
+   const std::lock_guard<std::mutex> subscribe_lock{_subscribe_mutex};
    _subscribe_callback = cb;
+   _pending_updates.clear();
+   _pending_update_positions.clear();
    _notify_remove_create = notify_remove_create;
    _subscribed_accounts.clear();
 
@@ -785,7 +804,10 @@ vector<optional<account_object>> database_api_impl::get_accounts(const vector<st
 }
 
 std::map<string, full_account> database_api::get_full_accounts(const vector<string> &names_or_ids, bool subscribe) {
-   return my->get_full_accounts(names_or_ids, subscribe);
+   auto impl = my;
+   return my->run_read_only([impl, names_or_ids, subscribe]() {
+      return impl->get_full_accounts(names_or_ids, subscribe);
+   });
 }
 
 std::map<std::string, full_account> database_api_impl::get_full_accounts(const vector<std::string> &names_or_ids, bool subscribe) {
@@ -809,8 +831,11 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts(const v
          continue;
 
       if (subscribe) {
-         FC_ASSERT(std::distance(_subscribed_accounts.begin(), _subscribed_accounts.end()) <= 100);
-         _subscribed_accounts.insert(account->get_id());
+         {
+            const std::lock_guard<std::mutex> subscribe_lock{_subscribe_mutex};
+            FC_ASSERT(std::distance(_subscribed_accounts.begin(), _subscribed_accounts.end()) <= 100);
+            _subscribed_accounts.insert(account->get_id());
+         }
          subscribe_to_item(account->id);
       }
 
@@ -1463,32 +1488,30 @@ market_ticker database_api_impl::get_ticker(const string &base, const string &qu
    result.quote_volume = 0;
 
    try {
-      const fc::time_point_sec now = fc::time_point::now();
-      const fc::time_point_sec yesterday = fc::time_point_sec(now.sec_since_epoch() - 86400);
-      const auto batch_size = 100;
-
-      vector<market_trade> trades = get_trade_history(base, quote, now, yesterday, batch_size);
-      if (!trades.empty()) {
-         result.latest = trades[0].price;
-
-         while (!trades.empty()) {
-            for (const market_trade &t : trades) {
-               result.base_volume += t.value;
-               result.quote_volume += t.amount;
-            }
-
-            trades = get_trade_history(base, quote, trades.back().date, yesterday, batch_size);
-         }
-
-         const auto last_trade_yesterday = get_trade_history(base, quote, yesterday, fc::time_point_sec(), 1);
-         if (!last_trade_yesterday.empty()) {
-            const auto price_yesterday = last_trade_yesterday[0].price;
-            result.percent_change = ((result.latest / price_yesterday) - 1) * 100;
-         }
-      } else {
-         const auto last_trade = get_trade_history(base, quote, now, fc::time_point_sec(), 1);
-         if (!last_trade.empty())
-            result.latest = last_trade[0].price;
+      auto base_id = assets[0]->id;
+      auto quote_id = assets[1]->id;
+      const bool swapped = base_id > quote_id;
+      if (swapped)
+         std::swap(base_id, quote_id);
+
+      const auto &ticker_idx = _db.get_index_type<graphene::market_history::market_ticker_index>().indices().get<graphene::market_history::by_market>();
+      auto itr = ticker_idx.find(std::make_tuple(base_id, quote_id));
+      if (itr != ticker_idx.end()) {
+         // the ticker keeps amounts of the asset with the lower id as base
+         auto to_real = [](const share_type a, int p) {
+            return double(a.value) / pow(10, p);
+         };
+         auto price_to_real = [&](const share_type ticker_base, const share_type ticker_quote) {
+            const share_type requested_base = swapped ? ticker_quote : ticker_base;
+            const share_type requested_quote = swapped ? ticker_base : ticker_quote;
+            return to_real(requested_base, assets[0]->precision) / to_real(requested_quote, assets[1]->precision);
+         };
+
+         result.latest = price_to_real(itr->latest_base, itr->latest_quote);
+         if (itr->base_volume > 0 && itr->last_day_base > 0 && itr->last_day_quote > 0)
+            result.percent_change = ((result.latest / price_to_real(itr->last_day_base, itr->last_day_quote)) - 1) * 100;
+         result.base_volume = to_real(swapped ? itr->quote_volume : itr->base_volume, assets[0]->precision);
+         result.quote_volume = to_real(swapped ? itr->base_volume : itr->quote_volume, assets[1]->precision);
       }
 
       const auto orders = get_order_book(base, quote, 1);
@@ -1595,50 +1618,92 @@ vector<market_trade> database_api_impl::get_trade_history(const string &base,
 
    if (base_id > quote_id)
       std::swap(base_id, quote_id);
-   const auto &history_idx = _db.get_index_type<graphene::market_history::history_index>().indices().get<by_key>();
-   history_key hkey;
-   hkey.base = base_id;
-   hkey.quote = quote_id;
-   hkey.sequence = std::numeric_limits<int64_t>::min();
-
-   auto price_to_real = [&](const share_type a, int p) {
-      return double(a.value) / pow(10, p);
-   };
 
    if (start.sec_since_epoch() == 0)
       start = fc::time_point_sec(fc::time_point::now());
 
-   uint32_t count = 0;
-   auto itr = history_idx.lower_bound(hkey);
+   // trades are ordered newest first within a market, seek to the first one before start
+   const auto &history_idx = _db.get_index_type<graphene::market_history::history_index>().indices().get<graphene::market_history::by_market_time>();
+   auto itr = history_idx.upper_bound(std::make_tuple(base_id, quote_id, start));
    vector<market_trade> result;
 
-   while (itr != history_idx.end() && count < limit && !(itr->key.base != base_id || itr->key.quote != quote_id || itr->time < stop)) {
-      if (itr->time < start) {
-         market_trade trade;
+   while (itr != history_idx.end() && result.size() < limit && itr->key.base == base_id && itr->key.quote == quote_id && itr->time >= stop) {
+      // both sides of a match are in the history, report the one paying the base asset
+      if (itr->op.pays.asset_id == base_id)
+         result.push_back(make_market_trade(*itr, assets));
+      ++itr;
+   }
+
+   return result;
+}
 
-         if (assets[0]->id == itr->op.receives.asset_id) {
-            trade.amount = price_to_real(itr->op.pays.amount, assets[1]->precision);
-            trade.value = price_to_real(itr->op.receives.amount, assets[0]->precision);
-         } else {
-            trade.amount = price_to_real(itr->op.receives.amount, assets[1]->precision);
-            trade.value = price_to_real(itr->op.pays.amount, assets[0]->precision);
-         }
+vector<market_trade> database_api::get_trade_history_by_sequence(const string &base,
+                                                                 const string &quote,
+                                                                 int64_t start,
+                                                                 fc::time_point_sec stop,
+                                                                 unsigned limit) const {
+   return my->get_trade_history_by_sequence(base, quote, start, stop, limit);
+}
 
-         trade.date = itr->time;
-         trade.price = trade.value / trade.amount;
+vector<market_trade> database_api_impl::get_trade_history_by_sequence(const string &base,
+                                                                      const string &quote,
+                                                                      int64_t start,
+                                                                      fc::time_point_sec stop,
+                                                                      unsigned limit) const {
+   FC_ASSERT(limit <= api_limit_get_trade_history_by_sequence,
+             "Number of querying trades can not be greater than ${configured_limit}",
+             ("configured_limit", api_limit_get_trade_history_by_sequence));
+   FC_ASSERT(start >= 0);
 
-         result.push_back(trade);
-         ++count;
-      }
+   auto assets = lookup_asset_symbols({base, quote});
+   FC_ASSERT(assets[0], "Invalid base asset symbol: ${s}", ("s", base));
+   FC_ASSERT(assets[1], "Invalid quote asset symbol: ${s}", ("s", quote));
 
-      // Trades are tracked in each direction.
-      ++itr;
+   auto base_id = assets[0]->id;
+   auto quote_id = assets[1]->id;
+
+   if (base_id > quote_id)
+      std::swap(base_id, quote_id);
+
+   // sequences are stored negated so that the newest trade of a market comes first
+   const auto &history_idx = _db.get_index_type<graphene::market_history::history_index>().indices().get<by_key>();
+   history_key hkey;
+   hkey.base = base_id;
+   hkey.quote = quote_id;
+   hkey.sequence = -start;
+   auto itr = history_idx.lower_bound(hkey);
+   vector<market_trade> result;
+
+   while (itr != history_idx.end() && result.size() < limit && itr->key.base == base_id && itr->key.quote == quote_id && itr->time >= stop) {
+      if (itr->op.pays.asset_id == base_id)
+         result.push_back(make_market_trade(*itr, assets));
       ++itr;
    }
 
    return result;
 }
 
+market_trade database_api_impl::make_market_trade(const order_history_object &history,
+                                                  const vector<optional<asset_object>> &assets) const {
+   auto price_to_real = [&](const share_type a, int p) {
+      return double(a.value) / pow(10, p);
+   };
+
+   market_trade trade;
+   if (assets[0]->id == history.op.receives.asset_id) {
+      trade.amount = price_to_real(history.op.pays.amount, assets[1]->precision);
+      trade.value = price_to_real(history.op.receives.amount, assets[0]->precision);
+   } else {
+      trade.amount = price_to_real(history.op.receives.amount, assets[1]->precision);
+      trade.value = price_to_real(history.op.pays.amount, assets[0]->precision);
+   }
+
+   trade.sequence = -history.key.sequence;
+   trade.date = history.time;
+   trade.price = trade.value / trade.amount;
+   return trade;
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Witnesses                                                        //
@@ -2176,7 +2241,10 @@ vector<account_object> database_api::get_voters_by_id(const vote_id_type &vote_i
 }
 
 voters_info database_api::get_voters(const string &account_name_or_id) const {
-   return my->get_voters(account_name_or_id);
+   auto impl = my;
+   return my->run_read_only([impl, account_name_or_id]() {
+      return impl->get_voters(account_name_or_id);
+   });
 }
 
 vector<variant> database_api_impl::lookup_vote_ids(const vector<vote_id_type> &votes) const {
@@ -2354,11 +2422,15 @@ votes_info database_api_impl::get_votes(const string &account_name_or_id) const
 vector<account_object> database_api_impl::get_voters_by_id(const vote_id_type &vote_id) const {
    vector<account_object> result;
 
-   //! We search all accounts that have voted for this vote_id
-   const auto &account_index = _db.get_index_type<graphene::chain::account_index>().indices().get<by_id>();
-   for (const auto &account : account_index) {
-      if (account.options.votes.count(vote_id) != 0)
-         result.emplace_back(account);
+   //! Accounts that have voted for this vote_id are tracked by the account_vote_index
+   const auto &idx = _db.get_index_type<graphene::chain::account_index>();
+   const auto &aidx = dynamic_cast<const base_primary_index &>(idx);
+   const auto &votes = aidx.get_secondary_index<graphene::chain::account_vote_index>();
+   auto itr = votes.vote_to_voters.find(vote_id);
+   if (itr != votes.vote_to_voters.end()) {
+      result.reserve(itr->second.size());
+      for (const auto &voter : itr->second)
+         result.emplace_back(voter(_db));
    }
 
    return result;
@@ -3476,14 +3548,46 @@ vector<account_role_object> database_api_impl::get_account_roles_by_owner(accoun
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-void database_api_impl::broadcast_updates(const vector<variant> &updates) {
-   if (updates.size() && _subscribe_callback) {
-      auto capture_this = shared_from_this();
-      fc::async([capture_this, updates]() {
-         if (capture_this->_subscribe_callback)
-            capture_this->_subscribe_callback(fc::variant(updates));
-      });
+void database_api_impl::broadcast_updates(const vector<std::pair<object_id_type, variant>> &updates) {
+   if (updates.empty() || !_subscribe_callback)
+      return;
+
+   // a later update of an object replaces the one still waiting, so a slow connection gets fewer, larger notifications
+   for (const auto &update : updates) {
+      auto pos = _pending_update_positions.find(update.first);
+      if (pos != _pending_update_positions.end())
+         _pending_updates[pos->second] = update.second;
+      else {
+         _pending_update_positions.emplace(update.first, _pending_updates.size());
+         _pending_updates.push_back(update.second);
+      }
+   }
+
+   if (_sending_updates)
+      return;
+   _sending_updates = true;
+   auto capture_this = shared_from_this();
+   fc::async([capture_this]() {
+      capture_this->send_pending_updates();
+   });
+}
+
+void database_api_impl::send_pending_updates() {
+   try {
+      // the callback may yield, updates queued meanwhile are sent by the next iteration
+      while (!_pending_updates.empty()) {
+         vector<variant> updates;
+         updates.swap(_pending_updates);
+         _pending_update_positions.clear();
+         if (_subscribe_callback)
+            _subscribe_callback(fc::variant(updates));
+      }
+   } catch (const fc::exception &e) {
+      wlog("Failed to send object updates to a subscriber: ${e}", ("e", e.to_detail_string()));
+      _pending_updates.clear();
+      _pending_update_positions.clear();
    }
+   _sending_updates = false;
 }
 
 void database_api_impl::broadcast_market_updates(const market_queue_type &queue) {
@@ -3499,45 +3603,32 @@ void database_api_impl::broadcast_market_updates(const market_queue_type &queue)
    }
 }
 
-void database_api_impl::on_objects_removed(const vector<object_id_type> &ids, const vector<const object *> &objs, const flat_set<account_id_type> &impacted_accounts) {
-   handle_object_changed(_notify_remove_create, false, ids, impacted_accounts,
-                         [objs](object_id_type id) -> const object * {
-                            auto it = std::find_if(
-                                  objs.begin(), objs.end(),
-                                  [id](const object *o) {
-                                     return o != nullptr && o->id == id;
-                                  });
-
-                            if (it != objs.end())
-                               return *it;
-
-                            return nullptr;
-                         });
+void database_api_impl::on_objects_removed(const object_update_batch &batch) {
+   handle_object_changed(_notify_remove_create, false, batch);
 }
 
-void database_api_impl::on_objects_new(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
-   handle_object_changed(_notify_remove_create, true, ids, impacted_accounts,
-                         std::bind(&object_database::find_object, &_db, std::placeholders::_1));
+void database_api_impl::on_objects_new(const object_update_batch &batch) {
+   handle_object_changed(_notify_remove_create, true, batch);
 }
 
-void database_api_impl::on_objects_changed(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
-   handle_object_changed(false, true, ids, impacted_accounts,
-                         std::bind(&object_database::find_object, &_db, std::placeholders::_1));
+void database_api_impl::on_objects_changed(const object_update_batch &batch) {
+   handle_object_changed(false, true, batch);
 }
 
-void database_api_impl::handle_object_changed(bool force_notify, bool full_object, const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts, std::function<const object *(object_id_type id)> find_object) {
+void database_api_impl::handle_object_changed(bool force_notify, bool full_object, const object_update_batch &batch) {
    if (_subscribe_callback) {
-      vector<variant> updates;
+      vector<std::pair<object_id_type, variant>> updates;
+      const bool impacted = is_impacted_account(batch.impacted_accounts);
 
-      for (auto id : ids) {
-         if (force_notify || is_subscribed_to_item(id) || is_impacted_account(impacted_accounts)) {
+      for (auto id : batch.ids) {
+         if (force_notify || impacted || is_subscribed_to_item(id)) {
             if (full_object) {
-               auto obj = find_object(id);
-               if (obj) {
-                  updates.emplace_back(obj->to_variant());
+               const variant &obj = batch.to_variant(id);
+               if (!obj.is_null()) {
+                  updates.emplace_back(id, obj);
                }
             } else {
-               updates.emplace_back(fc::variant(id, 1));
+               updates.emplace_back(id, fc::variant(id, 1));
             }
          }
       }
@@ -3554,11 +3645,11 @@ void database_api_impl::handle_object_changed(bool force_notify, bool full_objec
       //if( _subscribe_callback )
       //         _subscribe_callback( updates );
 
-      for (auto id : ids) {
+      for (auto id : batch.ids) {
          if (id.is<call_order_object>()) {
-            enqueue_if_subscribed_to_market<call_order_object>(find_object(id), broadcast_queue, full_object);
+            enqueue_if_subscribed_to_market<call_order_object>(batch, id, broadcast_queue, full_object);
          } else if (id.is<limit_order_object>()) {
-            enqueue_if_subscribed_to_market<limit_order_object>(find_object(id), broadcast_queue, full_object);
+            enqueue_if_subscribed_to_market<limit_order_object>(batch, id, broadcast_queue, full_object);
          }
       }
 
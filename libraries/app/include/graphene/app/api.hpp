@@ -124,6 +124,21 @@ public:
                                                                    operation_history_id_type stop = operation_history_id_type(),
                                                                    unsigned limit = 100) const;
 
+   /**
+          * @brief Get operations of any of the asked types relevant to the specified account
+          * @param account_id_or_name The account ID or name whose history should be queried
+          * @param operation_types The IDs of the operations we want to get in the account history
+          * @param start ID of the most recent operation to retrieve
+          * @param stop ID of the earliest operation to retrieve
+          * @param limit Maximum number of operations to retrieve (must not exceed 100)
+          * @return A list of operations performed by account, ordered from most recent to oldest.
+          */
+   vector<operation_history_object> get_account_history_by_operations(const std::string account_id_or_name,
+                                                                      const flat_set<int> &operation_types,
+                                                                      operation_history_id_type start = operation_history_id_type(),
+                                                                      operation_history_id_type stop = operation_history_id_type(),
+                                                                      unsigned limit = 100) const;
+
    /**
           * @breif Get operations relevant to the specified account referenced
           * by an event numbering specific to the account. The current number of operations
@@ -151,6 +166,12 @@ public:
    uint32_t api_limit_get_relative_account_history = 100;
 
 private:
+   vector<operation_history_object> get_account_history_by_operation_types(const std::string &account_id_or_name,
+                                                                          const flat_set<int> &operation_types,
+                                                                          operation_history_id_type start,
+                                                                          operation_history_id_type stop,
+                                                                          unsigned limit) const;
+
    application &_app;
    graphene::app::database_api database_api;
 };
@@ -169,6 +190,25 @@ private:
    graphene::chain::database &_db;
 };
 
+/**
+    * @brief The profiler_api class exposes the block application profile, see database::enable_block_profiling()
+    */
+class profiler_api {
+public:
+   profiler_api(graphene::chain::database &db);
+   ~profiler_api();
+
+   /**
+          * @brief Get the block application profile recorded by this node
+          * @param reset Whether to start a new profile once this one is returned
+          * @return The profile, or null if profiling is not enabled on this node
+          */
+   optional<block_profile> get_block_profile(bool reset) const;
+
+private:
+   graphene::chain::database &_db;
+};
+
 /**
     * @brief The network_broadcast_api class allows broadcasting of transactions.
     */
@@ -300,16 +340,16 @@ public:
    /**
           * @brief Get asset holders for a specific asset
           * @param asset The specific asset id or symbol
-          * @param start The start index
+          * @param start The start index in the holders ranked by balance
           * @param limit Maximum limit must not exceed 100
-          * @return A list of asset holders for the specified asset
+          * @return A list of asset holders for the specified asset, largest balance first
           */
    vector<account_asset_balance> get_asset_holders(std::string asset, uint32_t start, uint32_t limit) const;
 
    /**
           * @brief Get asset holders count for a specific asset
           * @param asset The specific asset id or symbol
-          * @return Holders count for the specified asset
+          * @return Number of accounts holding a non-zero balance of the specified asset
           */
    int get_asset_holders_count(std::string asset) const;
 
@@ -329,6 +369,7 @@ private:
 }} // namespace graphene::app
 
 extern template class fc::api<graphene::app::block_api>;
+extern template class fc::api<graphene::app::profiler_api>;
 extern template class fc::api<graphene::app::network_broadcast_api>;
 extern template class fc::api<graphene::app::network_node_api>;
 extern template class fc::api<graphene::app::history_api>;
@@ -376,6 +417,8 @@ public:
    fc::api<graphene::affiliate_stats::affiliate_stats_api> affiliate_stats() const;
    /// @brief Retrieve the sidechain_api API (if available)
    fc::api<graphene::peerplays_sidechain::sidechain_api> sidechain() const;
+   /// @brief Retrieve the profiler API
+   fc::api<profiler_api> profiler() const;
 
    /// @brief Called to enable an API, not reflected.
    void enable_api(const string &api_name);
@@ -392,6 +435,7 @@ private:
    optional<fc::api<graphene::bookie::bookie_api>> _bookie_api;
    optional<fc::api<graphene::affiliate_stats::affiliate_stats_api>> _affiliate_stats_api;
    optional<fc::api<graphene::peerplays_sidechain::sidechain_api>> _sidechain_api;
+   optional<fc::api<profiler_api>> _profiler_api;
 };
 
 }} // namespace graphene::app
@@ -418,6 +462,7 @@ FC_REFLECT(graphene::app::asset_holders,
 FC_API(graphene::app::history_api,
       (get_account_history)
       (get_account_history_operations)
+      (get_account_history_by_operations)
       (get_relative_account_history)
       (get_fill_order_history)
       (get_market_history)
@@ -427,6 +472,9 @@ FC_API(graphene::app::history_api,
 FC_API(graphene::app::block_api,
       (get_blocks))
 
+FC_API(graphene::app::profiler_api,
+      (get_block_profile))
+
 FC_API(graphene::app::network_broadcast_api,
       (broadcast_transaction)
       (broadcast_transaction_with_callback)
@@ -460,6 +508,7 @@ FC_API(graphene::app::login_api,
       (debug)
       (bookie)
       (affiliate_stats)
-      (sidechain))
+      (sidechain)
+      (profiler))
 
 // clang-format on
@@ -27,6 +27,8 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/net/node.hpp>
 
+#include <fc/thread/thread.hpp>
+
 #include <boost/program_options.hpp>
 
 namespace graphene { namespace app {
@@ -36,6 +38,7 @@ class application_impl;
 using std::string;
 
 class abstract_plugin;
+class subscription_hub;
 
 class application {
 public:
@@ -83,6 +86,8 @@ public:
 
    net::node_ptr p2p_node();
    std::shared_ptr<chain::database> chain_database() const;
+   /// @return the hub dispatching object changes to the database_api instances of this application
+   std::shared_ptr<subscription_hub> get_subscription_hub() const;
 
    void set_block_production(bool producing_blocks);
    fc::optional<api_access_info> get_api_access_info(const string &username) const;
@@ -98,7 +103,30 @@ public:
 
    std::shared_ptr<fc::thread> elasticsearch_thread;
 
+   /**
+    * @brief Runs a read-only API call on an API thread, or in place if no API threads are configured
+    *
+    * On an API thread the call runs while no block or transaction is being pushed, and the caller waits
+    * for at most api-call-timeout.  As the call may outlive a timed out caller, the callback must hold
+    * copies of everything it uses.
+    */
+   template <typename Lambda>
+   auto run_read_only_api_call(Lambda callback) const -> decltype(callback()) {
+      fc::thread *worker = next_api_thread();
+      if (worker == nullptr)
+         return callback();
+      auto db = chain_database();
+      return worker->async([db, callback]() {
+                      return db->with_read_lock(callback);
+                   },
+                           "read-only api call")
+            .wait(api_call_timeout());
+   }
+
 private:
+   fc::thread *next_api_thread() const;
+   fc::microseconds api_call_timeout() const;
+
    void add_available_plugin(std::shared_ptr<abstract_plugin> p);
    std::shared_ptr<detail::application_impl> my;
 
@@ -80,6 +80,7 @@ using namespace graphene::chain;
 using namespace graphene::market_history;
 using namespace std;
 
+class application;
 class database_api_impl;
 
 struct signed_block_with_info : public signed_block {
@@ -123,6 +124,7 @@ struct market_volume {
 };
 
 struct market_trade {
+   int64_t sequence = 0;
    fc::time_point_sec date;
    double price;
    double amount;
@@ -156,7 +158,11 @@ struct version_info {
  */
 class database_api {
 public:
-   database_api(graphene::chain::database &db);
+   /**
+    * @param db the chain database to query
+    * @param app if given, expensive queries run through application::run_read_only_api_call()
+    */
+   database_api(graphene::chain::database &db, const application *app = nullptr);
    ~database_api();
 
    /////////////
@@ -571,6 +577,17 @@ public:
     */
    vector<market_trade> get_trade_history(const string &base, const string &quote, fc::time_point_sec start, fc::time_point_sec stop, unsigned limit = 100) const;
 
+   /**
+    * @brief Returns trades for the market assetA:assetB, starting from a trade sequence number
+    * @param a String name of the first asset
+    * @param b String name of the second asset
+    * @param start Sequence of the latest trade to retrieve, as returned in market_trade::sequence
+    * @param stop Stop time as a UNIX timestamp, the earliest trade to retrieve
+    * @param limit Number of trasactions to retrieve, capped at 100
+    * @return Transactions in the market, newest first
+    */
+   vector<market_trade> get_trade_history_by_sequence(const string &base, const string &quote, int64_t start, fc::time_point_sec stop, unsigned limit = 100) const;
+
    ///////////////
    // Witnesses //
    ///////////////
@@ -1097,7 +1114,7 @@ FC_REFLECT(graphene::app::order, (price)(quote)(base));
 FC_REFLECT(graphene::app::order_book, (base)(quote)(bids)(asks));
 FC_REFLECT(graphene::app::market_ticker, (base)(quote)(latest)(lowest_ask)(highest_bid)(percent_change)(base_volume)(quote_volume));
 FC_REFLECT(graphene::app::market_volume, (base)(quote)(base_volume)(quote_volume));
-FC_REFLECT(graphene::app::market_trade, (date)(price)(amount)(value));
+FC_REFLECT(graphene::app::market_trade, (sequence)(date)(price)(amount)(value));
 FC_REFLECT(graphene::app::gpos_info, (vesting_factor)(award)(total_amount)(current_subperiod)(last_voted_time)(allowed_withdraw_amount)(account_vested_balance));
 FC_REFLECT(graphene::app::version_info, (version)(git_revision)(built)(openssl)(boost));
 
@@ -1184,6 +1201,7 @@ FC_API(graphene::app::database_api,
    (get_ticker)
    (get_24_volume)
    (get_trade_history)
+   (get_trade_history_by_sequence)
 
    // Witnesses
    (get_witnesses)
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/database.hpp>
+
+#include <boost/signals2.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace graphene { namespace app {
+using namespace graphene::chain;
+
+/**
+ * @brief Objects reported together by one of the object signals of the database
+ *
+ * Objects are converted to variants on first use and the variant is shared by every subscriber, so a changed object
+ * is serialized once per batch however many connections are subscribed to it.
+ */
+class object_update_batch {
+public:
+   object_update_batch(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts,
+                       std::function<const object *(object_id_type)> find_object);
+
+   const vector<object_id_type> &ids;
+   const flat_set<account_id_type> &impacted_accounts;
+
+   /// @return the object, or nullptr if it does not exist
+   const object *find(object_id_type id) const;
+   /// @return the object as a variant, or a null variant if it does not exist
+   const fc::variant &to_variant(object_id_type id) const;
+
+private:
+   std::function<const object *(object_id_type)> _find_object;
+   mutable std::unordered_map<object_id_type, fc::variant> _variants;
+};
+
+class object_update_subscriber {
+public:
+   virtual ~object_update_subscriber() {}
+   virtual void on_objects_new(const object_update_batch &batch) = 0;
+   virtual void on_objects_changed(const object_update_batch &batch) = 0;
+   virtual void on_objects_removed(const object_update_batch &batch) = 0;
+};
+
+/**
+ * @brief Connects once to the object signals of the database and fans each batch out to the subscribers
+ *
+ * Subscribers are held weakly and dropped once they are destroyed.
+ */
+class subscription_hub {
+public:
+   explicit subscription_hub(graphene::chain::database &db);
+
+   void subscribe(const std::shared_ptr<object_update_subscriber> &subscriber);
+   size_t subscriber_count() const;
+
+private:
+   /// @return the live subscribers, dropping the destroyed ones
+   vector<std::shared_ptr<object_update_subscriber>> live_subscribers();
+
+   graphene::chain::database &_db;
+   mutable std::mutex _subscribers_mutex;
+   vector<std::weak_ptr<object_update_subscriber>> _subscribers;
+
+   boost::signals2::scoped_connection _new_connection;
+   boost::signals2::scoped_connection _change_connection;
+   boost::signals2::scoped_connection _removed_connection;
+};
+
+}} // namespace graphene::app
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/app/subscription_hub.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace app {
+
+object_update_batch::object_update_batch(const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts,
+                                         std::function<const object *(object_id_type)> find_object) :
+      ids(ids),
+      impacted_accounts(impacted_accounts),
+      _find_object(std::move(find_object)) {
+}
+
+const object *object_update_batch::find(object_id_type id) const {
+   return _find_object(id);
+}
+
+const fc::variant &object_update_batch::to_variant(object_id_type id) const {
+   auto itr = _variants.find(id);
+   if (itr == _variants.end()) {
+      const object *obj = find(id);
+      itr = _variants.emplace(id, obj != nullptr ? obj->to_variant() : fc::variant()).first;
+   }
+   return itr->second;
+}
+
+subscription_hub::subscription_hub(graphene::chain::database &db) :
+      _db(db) {
+   _new_connection = _db.new_objects.connect([this](const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
+      object_update_batch batch(ids, impacted_accounts, std::bind(&object_database::find_object, &_db, std::placeholders::_1));
+      for (const auto &subscriber : live_subscribers())
+         subscriber->on_objects_new(batch);
+   });
+   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type> &ids, const flat_set<account_id_type> &impacted_accounts) {
+      object_update_batch batch(ids, impacted_accounts, std::bind(&object_database::find_object, &_db, std::placeholders::_1));
+      for (const auto &subscriber : live_subscribers())
+         subscriber->on_objects_changed(batch);
+   });
+   _removed_connection = _db.removed_objects.connect([this](const vector<object_id_type> &ids, const vector<const object *> &objs, const flat_set<account_id_type> &impacted_accounts) {
+      object_update_batch batch(ids, impacted_accounts, [&objs](object_id_type id) -> const object * {
+         auto it = std::find_if(objs.begin(), objs.end(), [id](const object *o) {
+            return o != nullptr && o->id == id;
+         });
+         return it != objs.end() ? *it : nullptr;
+      });
+      for (const auto &subscriber : live_subscribers())
+         subscriber->on_objects_removed(batch);
+   });
+}
+
+void subscription_hub::subscribe(const std::shared_ptr<object_update_subscriber> &subscriber) {
+   const std::lock_guard<std::mutex> subscribers_lock{_subscribers_mutex};
+   _subscribers.emplace_back(subscriber);
+}
+
+size_t subscription_hub::subscriber_count() const {
+   const std::lock_guard<std::mutex> subscribers_lock{_subscribers_mutex};
+   return std::count_if(_subscribers.begin(), _subscribers.end(), [](const std::weak_ptr<object_update_subscriber> &s) {
+      return !s.expired();
+   });
+}
+
+vector<std::shared_ptr<object_update_subscriber>> subscription_hub::live_subscribers() {
+   const std::lock_guard<std::mutex> subscribers_lock{_subscribers_mutex};
+   vector<std::shared_ptr<object_update_subscriber>> result;
+   result.reserve(_subscribers.size());
+   auto last = std::remove_if(_subscribers.begin(), _subscribers.end(), [&result](const std::weak_ptr<object_update_subscriber> &s) {
+      auto subscriber = s.lock();
+      if (!subscriber)
+         return true;
+      result.push_back(std::move(subscriber));
+      return false;
+   });
+   _subscribers.erase(last, _subscribers.end());
+   return result;
+}
+
+}} // namespace graphene::app
@@ -269,6 +269,61 @@ void account_referrer_index::object_modified( const object& after  )
 {
 }
 
+void account_vote_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(obj);
+   for( const auto& vote : a.options.votes )
+      vote_to_voters[vote].insert( a.id );
+}
+
+void account_vote_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(obj);
+   for( const auto& vote : a.options.votes )
+   {
+      auto itr = vote_to_voters.find( vote );
+      if( itr == vote_to_voters.end() ) continue;
+      itr->second.erase( a.id );
+      if( itr->second.empty() )
+         vote_to_voters.erase( itr );
+   }
+}
+
+void account_vote_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const account_object*>(&before) ); // for debug only
+   before_votes = static_cast<const account_object&>(before).options.votes;
+}
+
+void account_vote_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const account_object*>(&after) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(after);
+   const auto& after_votes = a.options.votes;
+
+   vector<vote_id_type> removed; removed.reserve(before_votes.size());
+   std::set_difference(before_votes.begin(), before_votes.end(),
+                       after_votes.begin(), after_votes.end(),
+                       std::inserter(removed, removed.end()));
+   for( const auto& vote : removed )
+   {
+      auto itr = vote_to_voters.find( vote );
+      if( itr == vote_to_voters.end() ) continue;
+      itr->second.erase( a.id );
+      if( itr->second.empty() )
+         vote_to_voters.erase( itr );
+   }
+
+   vector<vote_id_type> added; added.reserve(after_votes.size());
+   std::set_difference(after_votes.begin(), after_votes.end(),
+                       before_votes.begin(), before_votes.end(),
+                       std::inserter(added, added.end()));
+   for( const auto& vote : added )
+      vote_to_voters[vote].insert( a.id );
+}
+
 const uint8_t  balances_by_account_index::bits = 20;
 const uint64_t balances_by_account_index::mask = (1ULL << balances_by_account_index::bits) - 1;
 
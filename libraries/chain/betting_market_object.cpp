@@ -122,6 +122,73 @@ share_type bet_object::get_minimum_matching_amount() const
    return (back_or_lay == bet_type::lay ? GRAPHENE_BETTING_ODDS_PRECISION : backer_multiplier - GRAPHENE_BETTING_ODDS_PRECISION) / gcd;
 }
 
+namespace {
+   template<typename LevelMap>
+   void adjust_price_level(LevelMap& levels, bet_multiplier_type backer_multiplier, share_type amount, int64_t direction)
+   {
+      auto& level = levels[backer_multiplier];
+      level.amount_to_bet += direction * amount.value;
+      level.bet_count += direction;
+      if (level.bet_count == 0)
+         levels.erase(backer_multiplier);
+   }
+}
+
+void bet_order_book_index::add_bet( const bet_object& bet, int64_t direction )
+{
+   // delayed bets can't be matched yet, they join the book when their delay expires
+   if (bet.end_of_delay)
+      return;
+
+   order_book& book = _order_books[bet.betting_market_id];
+   if (bet.back_or_lay == bet_type::back)
+      adjust_price_level(book.back_levels, bet.backer_multiplier, bet.amount_to_bet.amount, direction);
+   else
+      adjust_price_level(book.lay_levels, bet.backer_multiplier, bet.amount_to_bet.amount, direction);
+
+   if (book.back_levels.empty() && book.lay_levels.empty())
+      _order_books.erase(bet.betting_market_id);
+}
+
+void bet_order_book_index::object_inserted( const object& obj )
+{
+   add_bet(static_cast<const bet_object&>(obj), 1);
+}
+
+void bet_order_book_index::object_removed( const object& obj )
+{
+   add_bet(static_cast<const bet_object&>(obj), -1);
+}
+
+void bet_order_book_index::about_to_modify( const object& before )
+{
+   add_bet(static_cast<const bet_object&>(before), -1);
+}
+
+void bet_order_book_index::object_modified( const object& after )
+{
+   add_bet(static_cast<const bet_object&>(after), 1);
+}
+
+const bet_order_book_index::order_book* bet_order_book_index::get_order_book( const betting_market_id_type& betting_market_id )const
+{
+   auto iter = _order_books.find(betting_market_id);
+   if (iter == _order_books.end())
+      return nullptr;
+   return &iter->second;
+}
+
+bool bet_order_book_index::has_matching_bets( const bet_object& taker_bet )const
+{
+   const order_book* book = get_order_book(taker_bet.betting_market_id);
+   if (!book)
+      return false;
+   // a back bet matches lays at the same or higher odds, a lay bet matches backs at the same or lower odds
+   if (taker_bet.back_or_lay == bet_type::back)
+      return !book->lay_levels.empty() && book->lay_levels.begin()->first >= taker_bet.backer_multiplier;
+   else
+      return !book->back_levels.empty() && book->back_levels.begin()->first <= taker_bet.backer_multiplier;
+}
 
 share_type betting_market_position_object::reduce()
 {
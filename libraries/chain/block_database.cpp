@@ -25,6 +25,14 @@
 #include <graphene/chain/protocol/fee_schedule.hpp>
 #include <fc/io/raw.hpp>
 
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace graphene { namespace chain {
 
 struct index_entry
@@ -38,40 +46,156 @@ FC_REFLECT( graphene::chain::index_entry, (block_pos)(block_size)(block_id) );
 
 namespace graphene { namespace chain {
 
-void block_database::open( const fc::path& dbdir )
-{ try {
-   fc::create_directories(dbdir);
-   _block_num_to_pos.exceptions(std::ios_base::failbit | std::ios_base::badbit);
-   _blocks.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+/// Smallest mapping created for a file, mappings grow by doubling from here
+static const uint64_t min_mapping_size = 16 * 1024 * 1024;
 
-   _index_filename = dbdir / "index";
-   if( !fc::exists( _index_filename ) )
+/**
+ * A read-only view of a file. The mapping may extend past the end of the file,
+ * readers only touch bytes below mapped_file::size.
+ */
+struct block_database::mapping
+{
+   mapping( int fd, uint64_t len ) : length( len )
    {
-     _block_num_to_pos.open( _index_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
-     _blocks.open( (dbdir/"blocks").generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
+      void* addr = ::mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+      FC_ASSERT( addr != MAP_FAILED, "Unable to map block database file: ${e}", ("e", std::strerror(errno)) );
+      data = static_cast<const char*>( addr );
    }
-   else
+   ~mapping()
+   {
+      ::munmap( const_cast<char*>( data ), length );
+   }
+
+   const char* data = nullptr;
+   uint64_t    length = 0;
+};
+
+void block_database::mapped_file::open( const fc::path& filename, bool truncate )
+{
+   fd = ::open( filename.generic_string().c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644 );
+   FC_ASSERT( fd >= 0, "Unable to open ${f}: ${e}", ("f", filename)("e", std::strerror(errno)) );
+   struct stat st;
+   FC_ASSERT( ::fstat( fd, &st ) == 0, "Unable to stat ${f}: ${e}", ("f", filename)("e", std::strerror(errno)) );
+   size = st.st_size;
+   remap( size );
+}
+
+void block_database::mapped_file::close()
+{
+   if( fd < 0 )
+      return;
+   sync();
+   ::close( fd );
+   fd = -1;
+   size = 0;
+   // readers which still hold the old mapping keep it alive until they are done
+   std::atomic_store( &map, std::shared_ptr<const mapping>() );
+}
+
+void block_database::mapped_file::sync()
+{
+   if( fd >= 0 )
+      ::fsync( fd );
+}
+
+void block_database::mapped_file::write( uint64_t pos, const char* data, size_t len )
+{
+   size_t written = 0;
+   while( written < len )
    {
-     _block_num_to_pos.open( _index_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
-     _blocks.open( (dbdir/"blocks").generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
+      ssize_t n = ::pwrite( fd, data + written, len - written, pos + written );
+      if( n < 0 && errno == EINTR )
+         continue;
+      FC_ASSERT( n > 0, "Unable to write to block database: ${e}", ("e", std::strerror(errno)) );
+      written += n;
    }
+   if( pos + len > size )
+   {
+      remap( pos + len );
+      size = pos + len;
+   }
+}
+
+void block_database::mapped_file::truncate( uint64_t new_size )
+{
+   FC_ASSERT( ::ftruncate( fd, new_size ) == 0, "Unable to truncate block database: ${e}", ("e", std::strerror(errno)) );
+   size = new_size;
+}
+
+bool block_database::mapped_file::read( uint64_t pos, char* out, size_t len )const
+{
+   if( pos + len > size )
+      return false;
+   std::shared_ptr<const mapping> current = std::atomic_load( &map );
+   if( current && pos + len <= current->length )
+   {
+      std::memcpy( out, current->data + pos, len );
+      return true;
+   }
+   size_t done = 0;
+   while( done < len )
+   {
+      ssize_t n = ::pread( fd, out + done, len - done, pos + done );
+      if( n < 0 && errno == EINTR )
+         continue;
+      if( n <= 0 )
+         return false;
+      done += n;
+   }
+   return true;
+}
+
+void block_database::mapped_file::remap( uint64_t required )
+{
+   std::shared_ptr<const mapping> current = std::atomic_load( &map );
+   if( current && required <= current->length )
+      return;
+   uint64_t length = current ? current->length : min_mapping_size;
+   while( length < required )
+      length *= 2;
+   std::atomic_store( &map, std::shared_ptr<const mapping>( std::make_shared<mapping>( fd, length ) ) );
+}
+
+block_database::block_database()
+{
+}
+
+block_database::~block_database()
+{
+   close();
+}
+
+void block_database::open( const fc::path& dbdir )
+{ try {
+   fc::create_directories(dbdir);
+   std::lock_guard<std::mutex> lock( _write_mutex );
+
+   const fc::path index_filename = dbdir / "index";
+   const bool create = !fc::exists( index_filename );
+   _block_num_to_pos.open( index_filename, create );
+   _blocks.open( dbdir / "blocks", create );
+   _unsynced_blocks = 0;
 } FC_CAPTURE_AND_RETHROW( (dbdir) ) }
 
 bool block_database::is_open()const
 {
-  return _blocks.is_open();
+  return _blocks.fd >= 0;
 }
 
 void block_database::close()
 {
+  std::lock_guard<std::mutex> lock( _write_mutex );
   _blocks.close();
   _block_num_to_pos.close();
 }
 
 void block_database::flush()
 {
-  _blocks.flush();
-  _block_num_to_pos.flush();
+  std::lock_guard<std::mutex> lock( _write_mutex );
+  // the index points into the blocks file, so the blocks must hit the disk first
+  _blocks.sync();
+  _block_num_to_pos.sync();
+  _unsynced_blocks = 0;
 }
 
 void block_database::store( const block_id_type& _id, const signed_block& b )
@@ -87,63 +211,83 @@ void block_database::store( const block_id_type& _id, const signed_block& b )
       elog( "id argument of block_database::store() was not initialized for block ${id}", ("id", id) );
    }
    auto num = block_header::num_from_id(id);
-   _block_num_to_pos.seekp( sizeof( index_entry ) * num );
-   index_entry e;
-   _blocks.seekp( 0, _blocks.end );
    auto vec = fc::raw::pack( b );
-   e.block_pos  = _blocks.tellp();
+
+   std::lock_guard<std::mutex> lock( _write_mutex );
+   index_entry e;
+   e.block_pos  = _blocks.size;
    e.block_size = vec.size();
    e.block_id   = id;
-   _blocks.write( vec.data(), vec.size() );
-   _block_num_to_pos.write( (char*)&e, sizeof(e) );
+   // the block is readable once its index entry is written
+   _blocks.write( e.block_pos, vec.data(), vec.size() );
+   _block_num_to_pos.write( sizeof( index_entry ) * num, (const char*)&e, sizeof(e) );
+
+   if( ++_unsynced_blocks >= blocks_per_sync )
+   {
+      _blocks.sync();
+      _block_num_to_pos.sync();
+      _unsynced_blocks = 0;
+   }
 }
 
 void block_database::remove( const block_id_type& id )
 { try {
+   std::lock_guard<std::mutex> lock( _write_mutex );
    index_entry e;
    auto index_pos = sizeof(e)*block_header::num_from_id(id);
-   _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-
-   std::streampos s_pos = _block_num_to_pos.tellg();
-   if (-1 == s_pos){ 
-      FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block ${id} not contained in block database, _block_num_to_pos.tellg failed", ("id", id));
-   }
 
-   if ( static_cast<uint32_t>(s_pos) <= index_pos ){
+   if ( _block_num_to_pos.size <= index_pos ){
       FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block ${id} not contained in block database", ("id", id));
    }
 
-   _block_num_to_pos.seekg( index_pos );
-   _block_num_to_pos.read( (char*)&e, sizeof(e) );
+   if( !read_index_entry( block_header::num_from_id(id), e ) )
+      return;
 
    if( e.block_id == id )
    {
       e.block_size = 0;
-      _block_num_to_pos.seekp( sizeof(e)*block_header::num_from_id(id) );
-      _block_num_to_pos.write( (char*)&e, sizeof(e) );
+      _block_num_to_pos.write( index_pos, (const char*)&e, sizeof(e) );
    }
 } FC_CAPTURE_AND_RETHROW( (id) ) }
 
+bool block_database::read_index_entry( uint32_t block_num, index_entry& e )const
+{
+   return _block_num_to_pos.read( sizeof(e) * uint64_t(block_num), (char*)&e, sizeof(e) );
+}
+
+optional<signed_block> block_database::read_block( const index_entry& e )const
+{
+   if( e.block_size == 0 || e.block_pos + e.block_size > _blocks.size )
+      return optional<signed_block>();
+
+   signed_block result;
+   std::shared_ptr<const mapping> current = std::atomic_load( &_blocks.map );
+   if( current && e.block_pos + e.block_size <= current->length )
+   {
+      // unpack straight from the mapped file
+      fc::datastream<const char*> ds( current->data + e.block_pos, e.block_size );
+      fc::raw::unpack( ds, result );
+   }
+   else
+   {
+      vector<char> data( e.block_size );
+      if( !_blocks.read( e.block_pos, data.data(), e.block_size ) )
+         return optional<signed_block>();
+      result = fc::raw::unpack<signed_block>(data);
+   }
+   FC_ASSERT( result.id() == e.block_id );
+   return result;
+}
+
 bool block_database::contains( const block_id_type& id )const
 { try {
    if( id == block_id_type() )
       return false;
 
    index_entry e;
-   auto index_pos = sizeof(e)*block_header::num_from_id(id);
-   _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-
-   std::streampos s_pos = _block_num_to_pos.tellg();
-   if (-1 == s_pos){
-      FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block ${id} not contained in block database, _block_num_to_pos.tellg failed", ("id", id));
-   }
-
-   if ( static_cast<uint32_t>(s_pos) < index_pos + sizeof(e) )
+   if( !read_index_entry( block_header::num_from_id(id), e ) )
       return false;
 
-   _block_num_to_pos.seekg( index_pos );
-   _block_num_to_pos.read( (char*)&e, sizeof(e) );
-
    return e.block_id == id && e.block_size > 0;
 } FC_CAPTURE_AND_RETHROW( (id) ) }
 
@@ -151,14 +295,9 @@ block_id_type block_database::fetch_block_id( uint32_t block_num )const
 {
    assert( block_num != 0 );
    index_entry e;
-   auto index_pos = sizeof(e)*block_num;
-   _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-   if ( _block_num_to_pos.tellg() <= int64_t(index_pos) )
+   if( !read_index_entry( block_num, e ) )
       FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block number ${block_num} not contained in block database", ("block_num", block_num));
 
-   _block_num_to_pos.seekg( index_pos );
-   _block_num_to_pos.read( (char*)&e, sizeof(e) );
-
    FC_ASSERT( e.block_id != block_id_type(), "Empty block_id in block_database (maybe corrupt on disk?)" );
    return e.block_id;
 }
@@ -168,29 +307,12 @@ optional<signed_block> block_database::fetch_optional( const block_id_type& id )
    try
    {
       index_entry e;
-      auto index_pos = sizeof(e)*block_header::num_from_id(id);
-      _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-      std::streampos s_pos = _block_num_to_pos.tellg();
-
-      if (-1 == s_pos){
-         FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block ${id} not contained in block database, _block_num_to_pos.tellg failed", ("id", id));
-      }
-
-      if ( static_cast<uint32_t>(s_pos) <= index_pos )
+      if( !read_index_entry( block_header::num_from_id(id), e ) )
          return {};
 
-      _block_num_to_pos.seekg( index_pos );
-      _block_num_to_pos.read( (char*)&e, sizeof(e) );
-
       if( e.block_id != id ) return optional<signed_block>();
 
-      vector<char> data( e.block_size );
-      _blocks.seekg( e.block_pos );
-      if (e.block_size)
-         _blocks.read( data.data(), e.block_size );
-      auto result = fc::raw::unpack<signed_block>(data);
-      FC_ASSERT( result.id() == e.block_id );
-      return result;
+      return read_block( e );
    }
    catch (const fc::exception&)
    {
@@ -206,25 +328,10 @@ optional<signed_block> block_database::fetch_by_number( uint32_t block_num )cons
    try
    {
       index_entry e;
-      auto index_pos = sizeof(e)*block_num;
-      _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-      std::streampos s_pos = _block_num_to_pos.tellg();
-      if (-1 == s_pos){
-         FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block ${block_num} not contained in block database, _block_num_to_pos.tellg failed", ("block_num", block_num));
-      }
-
-      if ( static_cast<uint32_t>(s_pos) <= index_pos )
+      if( !read_index_entry( block_num, e ) )
          return {};
 
-      _block_num_to_pos.seekg( index_pos, _block_num_to_pos.beg );
-      _block_num_to_pos.read( (char*)&e, sizeof(e) );
-
-      vector<char> data( e.block_size );
-      _blocks.seekg( e.block_pos );
-      _blocks.read( data.data(), e.block_size );
-      auto result = fc::raw::unpack<signed_block>(data);
-      FC_ASSERT( result.id() == e.block_id );
-      return result;
+      return read_block( e );
    }
    catch (const fc::exception&)
    {
@@ -240,37 +347,20 @@ optional<index_entry> block_database::last_index_entry()const {
    {
       index_entry e;
 
-      _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-      std::streampos pos = _block_num_to_pos.tellg();
-      if (-1 == pos){
-         FC_THROW_EXCEPTION(fc::key_not_found_exception, "last_index_entry tellg failed");
-      }
-
-      if( static_cast<size_t>(pos) < sizeof(index_entry) )
+      uint64_t pos = _block_num_to_pos.size;
+      if( pos < sizeof(index_entry) )
          return optional<index_entry>();
 
       pos -= pos % sizeof(index_entry);
 
-      _blocks.seekg( 0, _block_num_to_pos.end );
-      const std::streampos blocks_size = _blocks.tellg();
       while( pos > 0 )
       {
          pos -= sizeof(index_entry);
-         _block_num_to_pos.seekg( pos );
-         _block_num_to_pos.read( (char*)&e, sizeof(e) );
-         if( _block_num_to_pos.gcount() == sizeof(e) && e.block_size > 0
-                && e.block_pos + static_cast<uint64_t>(e.block_size) <= static_cast<uint64_t>(blocks_size) )
+         if( _block_num_to_pos.read( pos, (char*)&e, sizeof(e) ) && e.block_size > 0 )
             try
             {
-               vector<char> data( e.block_size );
-               _blocks.seekg( e.block_pos );
-               _blocks.read( data.data(), e.block_size );
-               if( _blocks.gcount() == e.block_size )
-               {
-                  const signed_block block = fc::raw::unpack<signed_block>(data);
-                  if( block.id() == e.block_id )
-                     return e;
-               }
+               if( read_block( e ).valid() )
+                  return e;
             }
             catch (const fc::exception&)
             {
@@ -278,7 +368,8 @@ optional<index_entry> block_database::last_index_entry()const {
             catch (const std::exception&)
             {
             }
-         fc::resize_file( _index_filename, pos );
+         std::lock_guard<std::mutex> lock( _write_mutex );
+         _block_num_to_pos.truncate( pos );
       }
    }
    catch (const fc::exception&)
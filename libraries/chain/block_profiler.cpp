@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/block_profiler.hpp>
+#include <graphene/chain/protocol/operations.hpp>
+
+#include <fc/io/json.hpp>
+
+namespace graphene { namespace chain {
+
+namespace {
+   struct operation_name_visitor
+   {
+      typedef string result_type;
+      template<typename Op>
+      string operator()( const Op& )const
+      {
+         string name = fc::get_typename<Op>::name();
+         auto pos = name.rfind( ':' );
+         return pos == string::npos ? name : name.substr( pos + 1 );
+      }
+   };
+
+   object_id_type index_key( const object_id_type& id )
+   {
+      return object_id_type( id.space(), id.type(), 0 );
+   }
+}
+
+const size_t profile_histogram::bucket_count;
+
+void profile_histogram::record( uint64_t value )
+{
+   if( buckets.empty() )
+      buckets.resize( bucket_count );
+   size_t bucket = 0;
+   for( uint64_t v = value; v != 0 && bucket < bucket_count - 1; v >>= 1 )
+      ++bucket;
+   ++buckets[bucket];
+   ++count;
+   total += value;
+   max = std::max( max, value );
+}
+
+block_profiler::block_profiler( uint32_t log_interval )
+   : _log_interval( log_interval )
+{
+}
+
+void block_profiler::record_phase( const char* phase, uint64_t microseconds )
+{
+   // a block can still fail after some of its phases ran, keep them out of the profile until it is applied
+   std::lock_guard<std::mutex> guard( _mutex );
+   _block_phases.emplace_back( phase, microseconds );
+}
+
+void block_profiler::begin_block()
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   _block_phases.clear();
+   _block_operations.clear();
+}
+
+void block_profiler::record_operation( int which, uint64_t microseconds )
+{
+   // pending transactions and proposals are evaluated outside of blocks too, keep them out of the block totals
+   std::lock_guard<std::mutex> guard( _mutex );
+   _block_operations.emplace_back( which, microseconds );
+}
+
+void block_profiler::record_block( uint32_t block_num, uint64_t microseconds, const graphene::db::undo_state* undo )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   if( _first_block == 0 )
+      _first_block = block_num;
+   _last_block = block_num;
+   _blocks.record( microseconds );
+   for( const auto& item : _block_phases )
+      _phases[item.first].record( item.second );
+   _block_phases.clear();
+   for( const auto& item : _block_operations )
+      _operations[item.first].record( item.second );
+   _block_operations.clear();
+
+   if( undo != nullptr )
+   {
+      for( const auto& id : undo->new_ids )
+         ++_objects[index_key( id )].created;
+      for( const auto& item : undo->old_values )
+         ++_objects[index_key( item.first )].modified;
+      for( const auto& item : undo->removed )
+         ++_objects[index_key( item.first )].removed;
+      _undo_state_sizes.record( undo->new_ids.size() + undo->old_values.size() + undo->removed.size() );
+   }
+
+   if( _log_interval > 0 && ++_blocks_since_log >= _log_interval )
+   {
+      _blocks_since_log = 0;
+      ilog( "Block profile: ${p}", ("p", fc::json::to_string( to_profile() )) );
+   }
+}
+
+block_profile block_profiler::get_profile( bool reset )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   block_profile result = to_profile();
+   if( reset )
+   {
+      _blocks_since_log = 0;
+      _first_block = 0;
+      _last_block = 0;
+      _blocks = profile_histogram();
+      _phases.clear();
+      _operations.clear();
+      _objects.clear();
+      _undo_state_sizes = profile_histogram();
+   }
+   return result;
+}
+
+block_profile block_profiler::to_profile()const
+{
+   block_profile result;
+   result.first_block = _first_block;
+   result.last_block = _last_block;
+   result.blocks = _blocks;
+   result.phases = _phases;
+   for( const auto& item : _operations )
+   {
+      operation op;
+      op.set_which( item.first );
+      result.operations[op.visit( operation_name_visitor() )] = item.second;
+   }
+   for( const auto& item : _objects )
+      result.objects[ std::to_string( item.first.space() ) + "." + std::to_string( item.first.type() ) ] = item.second;
+   result.undo_state_sizes = _undo_state_sizes;
+   return result;
+}
+
+} } // graphene::chain
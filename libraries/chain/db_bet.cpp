@@ -607,6 +607,14 @@ bool database::place_bet(const bet_object& new_bet_object)
            ("new_bet", new_bet_object));
    }
 
+   // nothing to walk if the best level on the other side of the book doesn't reach the taker's odds
+   const auto& order_books = get_index_type< primary_index< bet_object_index > >().get_secondary_index< bet_order_book_index >();
+   if (!order_books.has_matching_bets(new_bet_object))
+   {
+      fc_ddump(fc::logger::get("betting"), (new_bet_object));
+      return false;
+   }
+
    const auto& bet_odds_idx = get_index_type<bet_object_index>().indices().get<by_odds>();
 
    bet_type bet_type_to_match = new_bet_object.back_or_lay == bet_type::back ? bet_type::lay : bet_type::back;
@@ -42,9 +42,16 @@
 #include <graphene/chain/witness_schedule_object.hpp>
 #include <graphene/db/object_database.hpp>
 #include <fc/crypto/digest.hpp>
+#include <fc/thread/future.hpp>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <functional>
+#include <thread>
+
 namespace {
 
    struct proposed_operations_digest_accumulator
@@ -187,6 +194,7 @@ void database::check_transaction_for_duplicated_operations(const signed_transact
 bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
 //   idump((new_block.block_num())(new_block.id())(new_block.timestamp)(new_block.previous));
+   chain_state_write_lock write_lock( *this );
    bool result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -383,6 +391,7 @@ void database::update_witnesses( fork_item& fork_entry )const
  */
 processed_transaction database::push_transaction( const signed_transaction& trx, uint32_t skip )
 { try {
+   chain_state_write_lock write_lock( *this );
    processed_transaction result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -484,6 +493,7 @@ signed_block database::generate_block(
    uint32_t skip /* = 0 */
    )
 { try {
+   chain_state_write_lock write_lock( *this );
    signed_block result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -620,6 +630,7 @@ signed_block database::_generate_block(
  */
 void database::pop_block()
 { try {
+   chain_state_write_lock write_lock( *this );
    {
       const std::lock_guard<std::mutex> pending_tx_session_lock{_pending_tx_session_mutex};
       _pending_tx_session.reset();
@@ -638,6 +649,7 @@ void database::pop_block()
 
 void database::clear_pending()
 { try {
+   chain_state_write_lock write_lock( *this );
    const std::lock_guard<std::mutex> pending_tx_lock{_pending_tx_mutex};
    const std::lock_guard<std::mutex> pending_tx_session_lock{_pending_tx_session_mutex};
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
@@ -645,6 +657,26 @@ void database::clear_pending()
    _pending_tx_session.reset();
 } FC_CAPTURE_AND_RETHROW() }
 
+database::chain_state_write_lock::chain_state_write_lock( database& db )
+   : _db( db )
+{
+   if( _db._chain_state_writer.load() != std::this_thread::get_id() )
+   {
+      _db._chain_state_mutex.lock();
+      _db._chain_state_writer = std::this_thread::get_id();
+   }
+   ++_db._chain_state_write_depth;
+}
+
+database::chain_state_write_lock::~chain_state_write_lock()
+{
+   if( --_db._chain_state_write_depth == 0 )
+   {
+      _db._chain_state_writer = std::thread::id();
+      _db._chain_state_mutex.unlock();
+   }
+}
+
 uint32_t database::push_applied_operation( const operation& op )
 {
    _applied_ops.emplace_back(op);
@@ -699,6 +731,9 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
 
 void database::_apply_block( const signed_block& next_block )
 { try {
+   const auto apply_start = fc::time_point::now();
+   if( _block_profiler )
+      _block_profiler->begin_block();
    uint32_t next_block_num = next_block.block_num();
    uint32_t skip = get_node_properties().skip_flags;
    _applied_ops.clear();
@@ -717,59 +752,69 @@ void database::_apply_block( const signed_block& next_block )
 
    _issue_453_affected_assets.clear();
 
-   for( const auto& trx : next_block.transactions )
-   {
-      /* We do not need to push the undo state for each transaction
-       * because they either all apply and are valid or the
-       * entire block fails to apply.  We only need an "undo" state
-       * for transactions when validating broadcast transactions or
-       * when building a block.
-       */
-
-      apply_transaction( trx, skip );
-      // For real operations which are explicitly included in a transaction, virtual_op is 0.
-      // For VOPs derived directly from a real op,
-      //     use the real op's (block_num,trx_in_block,op_in_trx), virtual_op starts from 1.
-      // For VOPs created after processed all transactions,
-      //     trx_in_block = the_block.trsanctions.size(), virtual_op starts from 0.
-      ++_current_trx_in_block;
-      _current_op_in_trx  = 0;
-      _current_virtual_op = 0;
-   }
+   profile_phase( "apply_transactions", [&]() {
+      for( const auto& trx : next_block.transactions )
+      {
+         /* We do not need to push the undo state for each transaction
+          * because they either all apply and are valid or the
+          * entire block fails to apply.  We only need an "undo" state
+          * for transactions when validating broadcast transactions or
+          * when building a block.
+          */
+
+         _apply_transaction( trx, trx.precomputed_id );
+         // For real operations which are explicitly included in a transaction, virtual_op is 0.
+         // For VOPs derived directly from a real op,
+         //     use the real op's (block_num,trx_in_block,op_in_trx), virtual_op starts from 1.
+         // For VOPs created after processed all transactions,
+         //     trx_in_block = the_block.trsanctions.size(), virtual_op starts from 0.
+         ++_current_trx_in_block;
+         _current_op_in_trx  = 0;
+         _current_virtual_op = 0;
+      }
+   });
 
    if (global_props.parameters.witness_schedule_algorithm == GRAPHENE_WITNESS_SCHEDULED_ALGORITHM) {
-      update_witness_schedule(next_block);
+      profile_phase( "update_witness_schedule", [&]() {
+         update_witness_schedule(next_block);
 
-      for(const auto& active_sons : global_props.active_sons) {
-         if(!active_sons.second.empty()) {
-            update_son_schedule(active_sons.first, next_block);
+         for(const auto& active_sons : global_props.active_sons) {
+            if(!active_sons.second.empty()) {
+               update_son_schedule(active_sons.first, next_block);
+            }
          }
-      }
+      });
    }
 
-   const uint32_t missed = update_witness_missed_blocks( next_block );
-   update_global_dynamic_data( next_block, missed );
-   update_signing_witness(signing_witness, next_block);
-   update_last_irreversible_block();
+   profile_phase( "update_global_dynamic_data", [&]() {
+      const uint32_t missed = update_witness_missed_blocks( next_block );
+      update_global_dynamic_data( next_block, missed );
+      update_signing_witness(signing_witness, next_block);
+      update_last_irreversible_block();
+   });
 
    // Are we at the maintenance interval?
    if( maint_needed )
-      perform_chain_maintenance(next_block, global_props);
-
-   check_ending_lotteries();
-   check_ending_nft_lotteries();
-
-   create_block_summary(next_block);
-   place_delayed_bets(); // must happen after update_global_dynamic_data() updates the time
-   clear_expired_transactions();
-   clear_expired_proposals();
-   clear_expired_orders();
-   update_expired_feeds();       // this will update expired feeds and some core exchange rates
-   update_core_exchange_rates(); // this will update remaining core exchange rates
-   update_withdraw_permissions();
-   update_tournaments();
-   update_betting_markets(next_block.timestamp);
-   finalize_expired_offers();
+      profile_phase( "perform_chain_maintenance", [&]() { perform_chain_maintenance(next_block, global_props); } );
+
+   profile_phase( "check_ending_lotteries", [&]() {
+      check_ending_lotteries();
+      check_ending_nft_lotteries();
+   });
+
+   profile_phase( "create_block_summary", [&]() { create_block_summary(next_block); } );
+   profile_phase( "place_delayed_bets", [&]() { place_delayed_bets(); } ); // must happen after update_global_dynamic_data() updates the time
+   profile_phase( "clear_expired_transactions", [&]() { clear_expired_transactions(); } );
+   profile_phase( "clear_expired_proposals", [&]() { clear_expired_proposals(); } );
+   profile_phase( "clear_expired_orders", [&]() { clear_expired_orders(); } );
+   profile_phase( "update_expired_feeds", [&]() {
+      update_expired_feeds();       // this will update expired feeds and some core exchange rates
+      update_core_exchange_rates(); // this will update remaining core exchange rates
+   });
+   profile_phase( "update_withdraw_permissions", [&]() { update_withdraw_permissions(); } );
+   profile_phase( "update_tournaments", [&]() { update_tournaments(); } );
+   profile_phase( "update_betting_markets", [&]() { update_betting_markets(next_block.timestamp); } );
+   profile_phase( "finalize_expired_offers", [&]() { finalize_expired_offers(); } );
 
    // n.b., update_maintenance_flag() happens this late
    // because get_slot_time() / get_slot_at_time() is needed above
@@ -779,23 +824,29 @@ void database::_apply_block( const signed_block& next_block )
 
    update_maintenance_flag( maint_needed );
    if (global_props.parameters.witness_schedule_algorithm == GRAPHENE_WITNESS_SHUFFLED_ALGORITHM) {
-      update_witness_schedule();
+      profile_phase( "update_witness_schedule", [&]() {
+         update_witness_schedule();
 
-      for(const auto& active_sidechain_type : active_sidechain_types(dynamic_global_props.time)) {
-         if(global_props.active_sons.at(active_sidechain_type).size() > 0) {
-            update_son_schedule(active_sidechain_type);
+         for(const auto& active_sidechain_type : active_sidechain_types(dynamic_global_props.time)) {
+            if(global_props.active_sons.at(active_sidechain_type).size() > 0) {
+               update_son_schedule(active_sidechain_type);
+            }
          }
-      }
+      });
    }
 
    if( !_node_property_object.debug_updates.empty() )
       apply_debug_updates();
 
    // notify observers that the block has been applied
-   notify_applied_block( next_block ); //emit
+   profile_phase( "notify_applied_block", [&]() { notify_applied_block( next_block ); } ); //emit
    _applied_ops.clear();
 
-   notify_changed_objects();
+   profile_phase( "notify_changed_objects", [&]() { notify_changed_objects(); } );
+
+   if( _block_profiler )
+      _block_profiler->record_block( next_block_num, ( fc::time_point::now() - apply_start ).count(),
+                                     _undo_db.enabled() && _undo_db.size() > 0 ? &_undo_db.head() : nullptr );
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
 
@@ -823,7 +874,8 @@ class undo_size_restorer {
       size_t         old_max;
 };
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx)
+processed_transaction database::_apply_transaction(const signed_transaction& trx,
+                                                    const optional<transaction_id_type>& precomputed_id)
 { try {
    uint32_t skip = get_node_properties().skip_flags;
 
@@ -836,7 +888,7 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
 
    if( !(skip & skip_transaction_dupe_check) )
    {
-      trx_id = trx.id();
+      trx_id = precomputed_id.valid() ? *precomputed_id : trx.id();
       FC_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end() );
    }
 
@@ -916,11 +968,154 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
    FC_ASSERT( eval, "No registered evaluator for operation ${op}", ("op",op) );
    auto op_id = push_applied_operation( op );
+   const auto start = _block_profiler ? fc::time_point::now() : fc::time_point();
    auto result = eval->evaluate( eval_state, op, true );
+   if( _block_profiler )
+      _block_profiler->record_operation( i_which, ( fc::time_point::now() - start ).count() );
    set_applied_operation_result( op_id, result );
    return result;
 } FC_CAPTURE_AND_RETHROW( (op) ) }
 
+void database::_precompute_parallel( const processed_transaction* trx, size_t count, uint32_t skip )const
+{
+   const chain_id_type& chain_id = get_chain_id();
+   for( size_t i = 0; i < count; ++i, ++trx )
+   {
+      try
+      {
+         if( !(skip & skip_transaction_dupe_check) )
+            trx->precomputed_id = trx->id();
+         if( !(skip & (skip_transaction_signatures | skip_authority_check)) )
+            trx->get_signature_keys( chain_id );
+      }
+      catch( ... )
+      {
+         // invalid transactions are rejected with a proper error when the block is applied
+      }
+   }
+}
+
+boost::asio::thread_pool& database::precompute_pool()const
+{
+   std::call_once( _precompute_pool_created, [this]() {
+      _precompute_pool_size = std::max( 1u, std::thread::hardware_concurrency() );
+      _precompute_pool.reset( new boost::asio::thread_pool( _precompute_pool_size ) );
+   });
+   return *_precompute_pool;
+}
+
+namespace {
+
+/**
+ * Splits @p item_count items into one chunk per pool thread and runs @p work( first, count ) for each chunk in @p pool,
+ * then calls @p done from the thread that finished the last chunk
+ */
+void run_in_chunks( boost::asio::thread_pool& pool, size_t pool_size, size_t item_count,
+                    std::function<void( size_t, size_t )> work, std::function<void()> done )
+{
+   struct precompute_state
+   {
+      std::atomic<size_t>   chunks_left;
+      std::function<void()> done;
+   };
+
+   const size_t chunk_size = ( item_count + pool_size - 1 ) / pool_size;
+   const size_t chunk_count = ( item_count + chunk_size - 1 ) / chunk_size;
+
+   auto state = std::make_shared<precompute_state>();
+   state->chunks_left = chunk_count;
+   state->done = std::move( done );
+
+   for( size_t base = 0; base < item_count; base += chunk_size )
+   {
+      const size_t count = std::min( chunk_size, item_count - base );
+      boost::asio::post( pool, [state, work, base, count]() {
+         work( base, count );
+         if( --state->chunks_left == 0 )
+            state->done();
+      });
+   }
+}
+
+}
+
+std::future<void> database::precompute_parallel( const signed_block& block, const uint32_t skip )const
+{
+   std::promise<void> nothing_to_do;
+   nothing_to_do.set_value();
+
+   const bool need_ids = !(skip & skip_transaction_dupe_check);
+   const bool need_signatures = !(skip & (skip_transaction_signatures | skip_authority_check));
+   if( block.transactions.empty() || !(need_ids || need_signatures) )
+      return nothing_to_do.get_future();
+
+   boost::asio::thread_pool& pool = precompute_pool();
+   const processed_transaction* transactions = block.transactions.data();
+   auto done = std::make_shared<std::promise<void>>();
+   std::future<void> result = done->get_future();
+   run_in_chunks( pool, _precompute_pool_size, block.transactions.size(),
+                  [this, transactions, skip]( size_t first, size_t count ) {
+      _precompute_parallel( transactions + first, count, skip );
+   }, [done]() { done->set_value(); } );
+   return result;
+}
+
+fc::future<void> database::precheck_transactions_parallel( const vector<signed_transaction>& trxs,
+                                                           vector<fc::oexception>& errors )const
+{
+   errors.clear();
+   errors.resize( trxs.size() );
+
+   // an fc promise, so that the caller can wait on it without blocking the other tasks of its fc thread
+   fc::promise<void>::ptr done( new fc::promise<void>( "precheck_transactions_parallel" ) );
+   if( trxs.empty() )
+   {
+      done->set_value();
+      return fc::future<void>( done );
+   }
+
+   // everything read from the chain state is read here, on the calling thread
+   const uint32_t skip = get_node_properties().skip_flags;
+   const bool need_signatures = !(skip & (skip_transaction_signatures | skip_authority_check));
+   const chain_id_type chain_id = get_chain_id();
+   const chain_parameters& chain_parameters = get_global_properties().parameters;
+   const fc::time_point_sec now = head_block_time();
+   const fc::time_point_sec maximum_expiration = now + chain_parameters.maximum_time_until_expiration;
+   const bool check_expiration = head_block_num() > 0;
+
+   boost::asio::thread_pool& pool = precompute_pool();
+   const signed_transaction* transactions = trxs.data();
+   fc::oexception* results = errors.data();
+   run_in_chunks( pool, _precompute_pool_size, trxs.size(),
+                  [=]( size_t first, size_t count ) {
+      for( size_t i = first; i < first + count; ++i )
+      {
+         const signed_transaction& trx = transactions[i];
+         try
+         {
+            trx.validate();
+            if( check_expiration )
+            {
+               FC_ASSERT( trx.expiration <= maximum_expiration, "",
+                          ("trx.expiration",trx.expiration)("now",now)("max_til_exp",maximum_expiration - now) );
+               FC_ASSERT( now <= trx.expiration, "", ("now",now)("trx.exp",trx.expiration) );
+            }
+            if( need_signatures )
+               trx.get_signature_keys( chain_id );
+         }
+         catch( const fc::exception& e )
+         {
+            results[i] = e;
+         }
+         catch( const std::exception& e )
+         {
+            results[i] = fc::exception( FC_LOG_MESSAGE( error, "${what}", ("what", e.what()) ) );
+         }
+      }
+   }, [done]() { done->set_value(); } );
+   return fc::future<void>( done );
+}
+
 const witness_object& database::validate_block_header( uint32_t skip, const signed_block& next_block )const
 {
    FC_ASSERT( head_block_id() == next_block.previous, "", ("head_block_id",head_block_id())("next.prev",next_block.previous) );
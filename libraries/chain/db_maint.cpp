@@ -1497,7 +1497,7 @@ double database::calculate_vesting_factor(const account_object& stake_account)
    return vesting_factor;
 }
 
-share_type credit_account(database& db, const account_id_type owner_id, const std::string owner_name,
+share_type credit_account(database& db, const account_id_type owner_id,
                           share_type remaining_amount_to_distribute,
                           const share_type shares_to_credit, const asset_id_type payout_asset_type,
                           const pending_dividend_payout_balance_for_holder_object_index& pending_payout_balance_index,
@@ -1509,7 +1509,7 @@ share_type credit_account(database& db, const account_id_type owner_id, const st
       remaining_amount_to_distribute -= shares_to_credit;
 
       dlog("Crediting account ${account} with ${amount}",
-           ("account", owner_name)
+           ("account", owner_id(db).name)
                  ("amount", asset(shares_to_credit, payout_asset_type)));
       auto pending_payout_iter =
             pending_payout_balance_index.indices().get<by_dividend_payout_account>().find(
@@ -1587,7 +1587,7 @@ void schedule_pending_dividend_balances(database& db,
 { try {
    dlog("Processing dividend payments for dividend holder asset type ${holder_asset} at time ${t}",
         ("holder_asset", dividend_holder_asset_obj.symbol)("t", db.head_block_time()));
-   auto balance_by_acc_index = db.get_index_type< primary_index< account_balance_index > >().get_secondary_index< balances_by_account_index >();
+   const auto& balance_by_acc_index = db.get_index_type< primary_index< account_balance_index > >().get_secondary_index< balances_by_account_index >();
    auto current_distribution_account_balance_range =
       //balance_index.indices().get<by_account_asset>().equal_range(boost::make_tuple(dividend_data.dividend_distribution_account));
       balance_by_acc_index.get_account_balances(dividend_data.dividend_distribution_account);
@@ -1606,12 +1606,19 @@ void schedule_pending_dividend_balances(database& db,
    uint64_t distribution_base_fee = gpo.parameters.current_fees->get<asset_dividend_distribution_operation>().distribution_base_fee;
    uint32_t distribution_fee_per_holder = gpo.parameters.current_fees->get<asset_dividend_distribution_operation>().distribution_fee_per_holder;
 
-   std::map<account_id_type, share_type> vesting_amounts;
-
    auto balance_type = vesting_balance_type::normal;
    if(db.head_block_time() >= HARDFORK_GPOS_TIME)
       balance_type = vesting_balance_type::gpos;
 
+   // after GPOS, core dividends are shared out by vesting balance alone; every other case shares
+   // out by liquid balance plus any vesting balance of the dividend asset
+   const bool pay_by_vesting_balance = db.head_block_time() >= HARDFORK_GPOS_TIME &&
+                                       dividend_holder_asset_obj.symbol == GRAPHENE_SYMBOL;
+   std::map<account_id_type, share_type> vesting_amounts;
+   // vesting factor of each vesting balance, in index order, so it is computed once rather than
+   // once per payout asset
+   std::vector<double> vesting_factors;
+
    uint32_t holder_account_count = 0;
 
    // get only once a collection of accounts that hold nonzero vesting balances of the dividend asset
@@ -1622,7 +1629,8 @@ void schedule_pending_dividend_balances(database& db,
 
    for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
    {
-        vesting_amounts[vesting_balance_obj.owner] += vesting_balance_obj.balance.amount;
+        if (!pay_by_vesting_balance)
+           vesting_amounts[vesting_balance_obj.owner] += vesting_balance_obj.balance.amount;
         ++holder_account_count;
         dlog("Vesting balance for account: ${owner}, amount: ${amount}",
              ("owner", vesting_balance_obj.owner(db).name)
@@ -1645,12 +1653,18 @@ void schedule_pending_dividend_balances(database& db,
    // accounts other than the distribution account (it would be silly to distribute dividends back to
    // the distribution account)
    share_type total_balance_of_dividend_asset;
-   if(db.head_block_time() >= HARDFORK_GPOS_TIME && dividend_holder_asset_obj.symbol == GRAPHENE_SYMBOL) { // only core
+   if(pay_by_vesting_balance) { // only core
+      vesting_factors.reserve(holder_account_count);
       for (const vesting_balance_object &holder_balance_object : boost::make_iterator_range(vesting_balances_begin,
                                                                                             vesting_balances_end))
+      {
          if (holder_balance_object.owner != dividend_data.dividend_distribution_account) {
             total_balance_of_dividend_asset += holder_balance_object.balance.amount;
+            vesting_factors.push_back(db.calculate_vesting_factor(holder_balance_object.owner(db)));
          }
+         else
+            vesting_factors.push_back(0);
+      }
    }
    else {
       for (const account_balance_object &holder_balance_object : boost::make_iterator_range(holder_balances_begin,
@@ -1785,14 +1799,14 @@ void schedule_pending_dividend_balances(database& db,
                     ("total", total_balance_of_dividend_asset));
                share_type remaining_amount_to_distribute = delta_balance;
 
-               if(db.head_block_time() >= HARDFORK_GPOS_TIME && dividend_holder_asset_obj.symbol == GRAPHENE_SYMBOL) { // core only
+               if(pay_by_vesting_balance) { // core only
                   // credit each account with their portion, don't send any back to the dividend distribution account
+                  auto vesting_factor_iter = vesting_factors.begin();
                   for (const vesting_balance_object &holder_balance_object : boost::make_iterator_range(
                         vesting_balances_begin, vesting_balances_end)) {
+                     const double vesting_factor = *vesting_factor_iter++;
                      if (holder_balance_object.owner == dividend_data.dividend_distribution_account) continue;
 
-                     auto vesting_factor = db.calculate_vesting_factor(holder_balance_object.owner(db));
-
                      auto holder_balance = holder_balance_object.balance;
 
                      fc::uint128_t amount_to_credit(delta_balance.value);
@@ -1812,7 +1826,6 @@ void schedule_pending_dividend_balances(database& db,
 
                      remaining_amount_to_distribute = credit_account(db,
                                                                      holder_balance_object.owner,
-                                                                     holder_balance_object.owner(db).name,
                                                                      remaining_amount_to_distribute,
                                                                      shares_to_credit,
                                                                      payout_asset_type,
@@ -1839,7 +1852,6 @@ void schedule_pending_dividend_balances(database& db,
 
                      remaining_amount_to_distribute = credit_account(db,
                                                                      holder_balance_object.owner,
-                                                                     holder_balance_object.owner(db).name,
                                                                      remaining_amount_to_distribute,
                                                                      shares_to_credit,
                                                                      payout_asset_type,
@@ -2347,11 +2359,25 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    struct vote_tally_helper {
       database& d;
       const global_property_object& props;
-      std::map<account_id_type, share_type> vesting_amounts;
+      const vesting_balance_stake_index::stake_map* vesting_amounts = nullptr;
+      vesting_balance_stake_index::stake_map pre_gpos_vesting_amounts;
 
       vote_tally_helper(database& d, const global_property_object& gpo)
          : d(d), props(gpo)
       {
+         // per-account vesting totals are maintained incrementally by the secondary index
+         const auto& stakes = d.get_index_type< primary_index< vesting_balance_index > >()
+                               .get_secondary_index< vesting_balance_stake_index >();
+         if( d.head_block_time() >= HARDFORK_GPOS_TIME )
+            vesting_amounts = &stakes.get_core_stakes( vesting_balance_type::gpos );
+         else
+         {
+            // fees processed during the tally may deposit cashback into normal vesting balances,
+            // so tally against the totals as of the start of maintenance
+            pre_gpos_vesting_amounts = stakes.get_core_stakes( vesting_balance_type::normal );
+            vesting_amounts = &pre_gpos_vesting_amounts;
+         }
+
          d._vote_tally_buffer.resize(props.next_available_vote_id);
          d._witness_count_histogram_buffer.resize(props.parameters.maximum_witness_count / 2 + 1);
          d._committee_count_histogram_buffer.resize(props.parameters.maximum_committee_count / 2 + 1);
@@ -2359,25 +2385,6 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
             son_count_histogram_buffer.second.resize(props.parameters.maximum_son_count() / 2 + 1);
          }
          d._total_voting_stake = 0;
-
-         auto balance_type = vesting_balance_type::normal;
-         if(d.head_block_time() >= HARDFORK_GPOS_TIME)
-            balance_type = vesting_balance_type::gpos;
-
-         const vesting_balance_index& vesting_index = d.get_index_type<vesting_balance_index>();
-
-         auto vesting_balances_begin =
-              vesting_index.indices().get<by_asset_balance>().lower_bound(boost::make_tuple(asset_id_type(), balance_type));
-         auto vesting_balances_end =
-              vesting_index.indices().get<by_asset_balance>().upper_bound(boost::make_tuple(asset_id_type(), balance_type, share_type()));
-         for (const vesting_balance_object& vesting_balance_obj : boost::make_iterator_range(vesting_balances_begin, vesting_balances_end))
-         {
-            vesting_amounts[vesting_balance_obj.owner] += vesting_balance_obj.balance.amount;
-            dlog("Vesting balance for account: ${owner}, amount: ${amount}",
-                 ("owner", vesting_balance_obj.owner(d).name)
-                 ("amount", vesting_balance_obj.balance.amount));
-         }
-
       }
 
       void operator()( const account_object& stake_account, const account_statistics_object& stats )
@@ -2400,13 +2407,13 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
             const auto& stats = stake_account.statistics(d);
             uint64_t voting_stake = 0;
 
-            auto itr = vesting_amounts.find(stake_account.id);
-            if (itr != vesting_amounts.end())
-                voting_stake += itr->second.value;
+            auto itr = vesting_amounts->find(stake_account.id);
+            if (itr != vesting_amounts->end())
+                voting_stake += itr->second.amount.value;
 
             if(d.head_block_time() >= HARDFORK_GPOS_TIME)
             {
-               if (itr == vesting_amounts.end() && d.head_block_time() >= (HARDFORK_GPOS_TIME + props.parameters.gpos_subperiod()/2))
+               if (itr == vesting_amounts->end() && d.head_block_time() >= (HARDFORK_GPOS_TIME + props.parameters.gpos_subperiod()/2))
                   return;
 
                auto vesting_factor = d.calculate_vesting_factor(stake_account);
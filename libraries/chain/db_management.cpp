@@ -33,9 +33,16 @@
 
 #include <fc/io/fstream.hpp>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <thread>
 
 namespace graphene { namespace chain {
 
@@ -96,6 +103,162 @@ public:
     }
 };
 
+/**
+ * Feeds blocks to database::reindex().
+ *
+ * A reader thread fetches and unpacks blocks from the block log into a bounded queue. For each block
+ * it hands the merkle root verification to the worker pool, so that the chain thread only has to
+ * apply blocks. Transaction ids and signatures are not precomputed, reindex skips the dupe and
+ * signature checks which would use them.
+ */
+class replay_pipeline
+{
+public:
+   struct item
+   {
+      optional<signed_block> block;
+      /// Set when the worker pool verified the transaction merkle root of the block
+      bool                   merkle_verified = false;
+      std::promise<void>     merkle_checked;
+      std::future<void>      merkle_done;
+   };
+
+   replay_pipeline( boost::asio::thread_pool& pool, const block_database& blocks,
+                    uint32_t first, uint32_t last, uint32_t skip )
+      : _pool(pool), _blocks(blocks), _skip(skip),
+        _first(first), _last(last), _start_time(fc::time_point::now())
+   {
+      _last_report_time = _start_time;
+      _last_report_block = first - 1;
+      _reader = std::thread( [this]() { read_blocks(); } );
+   }
+
+   ~replay_pipeline()
+   {
+      stop();
+   }
+
+   /// Returns the next block in order, waiting for it to be read and its merkle root checked
+   std::shared_ptr<item> next()
+   {
+      std::shared_ptr<item> result;
+      {
+         std::unique_lock<std::mutex> lock( _mutex );
+         _cond.wait( lock, [this]() { return !_queue.empty(); } );
+         result = _queue.front();
+         _queue.pop_front();
+      }
+      _cond.notify_all();
+      if( result->block.valid() )
+         result->merkle_done.wait();
+      return result;
+   }
+
+   /// Stops the reader thread and waits for all background work on queued blocks
+   void stop()
+   {
+      {
+         std::lock_guard<std::mutex> lock( _mutex );
+         _stopped = true;
+      }
+      _cond.notify_all();
+      if( _reader.joinable() )
+         _reader.join();
+      std::lock_guard<std::mutex> lock( _mutex );
+      for( const auto& queued : _queue )
+         if( queued->block.valid() )
+            queued->merkle_done.wait();
+      _queue.clear();
+   }
+
+   /// Logs progress and throughput every few thousand blocks
+   void report_progress( uint32_t applied_block_num )
+   {
+      if( applied_block_num % blocks_per_report != 0 && applied_block_num != _last )
+         return;
+      const fc::time_point now = fc::time_point::now();
+      const double interval = double( (now - _last_report_time).count() ) / 1000000.0;
+      const double elapsed = double( (now - _start_time).count() ) / 1000000.0;
+      const uint32_t done = applied_block_num - _first + 1;
+      const uint32_t total = _last - _first + 1;
+      size_t queued;
+      {
+         std::lock_guard<std::mutex> lock( _mutex );
+         queued = _queue.size();
+      }
+      ilog( "Replayed block ${n} of ${last} (${p}%), ${r} blocks/s recently, ${a} blocks/s overall, ${q} blocks read ahead",
+            ("n", applied_block_num)("last", _last)("p", done * 100 / total)
+            ("r", interval > 0 ? uint64_t( (applied_block_num - _last_report_block) / interval ) : 0)
+            ("a", elapsed > 0 ? uint64_t( done / elapsed ) : 0)("q", queued) );
+      _last_report_time = now;
+      _last_report_block = applied_block_num;
+   }
+
+   static const size_t   max_queued_blocks = 1000;
+   static const uint32_t blocks_per_report = 10000;
+
+private:
+   void read_blocks()
+   {
+      for( uint32_t num = _first; num <= _last && !_stopped; ++num )
+      {
+         auto next_item = std::make_shared<item>();
+         next_item->block = _blocks.fetch_by_number( num );
+         if( next_item->block.valid() )
+         {
+            next_item->merkle_done = next_item->merkle_checked.get_future();
+            if( _skip & database::skip_merkle_check )
+               next_item->merkle_checked.set_value();
+            else
+               boost::asio::post( _pool, [next_item]() {
+                  try
+                  {
+                     const signed_block& block = *next_item->block;
+                     next_item->merkle_verified = ( block.transaction_merkle_root == block.calculate_merkle_root() );
+                  }
+                  catch( ... )
+                  {
+                     // the chain thread checks the merkle root itself and reports the error
+                  }
+                  next_item->merkle_checked.set_value();
+               });
+         }
+
+         std::unique_lock<std::mutex> lock( _mutex );
+         _cond.wait( lock, [this]() { return _stopped || _queue.size() < max_queued_blocks; } );
+         if( _stopped )
+         {
+            if( next_item->block.valid() )
+               next_item->merkle_done.wait();
+            break;
+         }
+         _queue.push_back( next_item );
+         lock.unlock();
+         _cond.notify_all();
+
+         // a missing block ends the replay, there is nothing more to read
+         if( !next_item->block.valid() )
+            break;
+      }
+   }
+
+   boost::asio::thread_pool&  _pool;
+   const block_database&      _blocks;
+   const uint32_t             _skip;
+   const uint32_t             _first;
+   const uint32_t             _last;
+
+   std::thread                        _reader;
+   std::atomic<bool>                  _stopped{false};
+   std::mutex                         _mutex;
+   std::condition_variable            _cond;
+   std::deque<std::shared_ptr<item>>  _queue;
+
+   const fc::time_point       _start_time;
+   fc::time_point             _last_report_time;
+   uint32_t                   _last_report_block;
+};
+
 void database::reindex( fc::path data_dir )
 { try {
    auto last_block = _block_id_to_block.last();
@@ -122,6 +285,13 @@ void database::reindex( fc::path data_dir )
    {
        undo.disable();
    }
+   const uint32_t skip = skip_witness_signature |
+                         skip_transaction_signatures |
+                         skip_transaction_dupe_check |
+                         skip_tapos_check |
+                         skip_witness_schedule_check |
+                         skip_authority_check;
+   replay_pipeline pipeline( precompute_pool(), _block_id_to_block, head_block_num() + 1, last_block_num, skip );
    for( uint32_t i = head_block_num() + 1; i <= last_block_num; ++i )
    {
       if( i % 1000000 == 0 )
@@ -130,9 +300,11 @@ void database::reindex( fc::path data_dir )
          flush();
          ilog( "Done" );
       }
-      fc::optional< signed_block > block = _block_id_to_block.fetch_by_number(i);
+      std::shared_ptr<replay_pipeline::item> next = pipeline.next();
+      const fc::optional< signed_block >& block = next->block;
       if( !block.valid() )
       {
+         pipeline.stop();
          wlog( "Reindexing terminated due to gap:  Block ${i} does not exist!", ("i", i) );
          uint32_t dropped_count = 0;
          while( true )
@@ -150,26 +322,19 @@ void database::reindex( fc::path data_dir )
          wlog( "Dropped ${n} blocks from after the gap", ("n", dropped_count) );
          break;
       }
+      const uint32_t block_skip = next->merkle_verified ? ( skip | skip_merkle_check ) : skip;
       if( i < undo_point && !_slow_replays)
       {
-         apply_block(*block, skip_witness_signature |
-                             skip_transaction_signatures |
-                             skip_transaction_dupe_check |
-                             skip_tapos_check |
-                             skip_witness_schedule_check |
-                             skip_authority_check);
+         apply_block(*block, block_skip);
       }
       else
       {
          undo.enable();
-         push_block(*block, skip_witness_signature |
-                            skip_transaction_signatures |
-                            skip_transaction_dupe_check |
-                            skip_tapos_check |
-                            skip_witness_schedule_check |
-                            skip_authority_check);
+         push_block(*block, block_skip);
       }
+      pipeline.report_progress( i );
    }
+   pipeline.stop();
    undo.enable();
    auto end = fc::time_point::now();
    ilog( "Done reindexing, elapsed time: ${t} sec", ("t",double((end-start).count())/1000000.0 ) );
@@ -202,8 +367,16 @@ void database::open(
          fc::read_file_contents( data_dir / "db_version", version_string );
          wipe_object_db = ( version_string != db_version );
       }
-      if( wipe_object_db ) {
-          ilog("Wiping object_database due to missing or wrong version");
+      if( _snapshot_to_restore.valid() && !wipe_object_db && !_snapshot_replaces_existing )
+         FC_ASSERT( !fc::exists( data_dir / "object_database" ),
+                    "Refusing to replace the existing object database with snapshot ${s}, "
+                    "use snapshot-restore-force to overwrite it",
+                    ("s", *_snapshot_to_restore) );
+      if( wipe_object_db || _snapshot_to_restore.valid() ) {
+          if( _snapshot_to_restore.valid() )
+             ilog("Wiping object_database to restore snapshot ${s}", ("s", *_snapshot_to_restore));
+          else
+             ilog("Wiping object_database due to missing or wrong version");
           object_database::wipe( data_dir );
           std::ofstream version_file( (data_dir / "db_version").generic_string().c_str(),
                                       std::ios::out | std::ios::binary | std::ios::trunc );
@@ -212,6 +385,11 @@ void database::open(
       }
 
       object_database::open(data_dir);
+      if( _snapshot_to_restore.valid() )
+      {
+         object_database::load_snapshot( *_snapshot_to_restore );
+         _snapshot_to_restore.reset();
+      }
 
       _block_id_to_block.open(data_dir / "database" / "block_num_to_block");
 
@@ -296,35 +474,82 @@ void database::force_slow_replays()
    _slow_replays = true;
 }
 
+void database::enable_block_profiling( bool enable, uint32_t log_interval )
+{
+   if( enable )
+   {
+      ilog( "enabling block profiling" );
+      _block_profiler.reset( new block_profiler( log_interval ) );
+   }
+   else
+      _block_profiler.reset();
+}
+
+optional<block_profile> database::get_block_profile( bool reset )const
+{
+   if( !_block_profiler )
+      return optional<block_profile>();
+   return _block_profiler->get_profile( reset );
+}
+
 void database::check_ending_lotteries()
 {
    try {
+      // Only the first expired lottery in active_lotteries order is ended per block; look it up directly
+      // instead of walking the lotteries that have not expired yet.
       const auto& lotteries_idx = get_index_type<asset_index>().indices().get<active_lotteries>();
-      for( auto checking_asset: lotteries_idx )
-      {
-         FC_ASSERT( checking_asset.is_lottery() );
-         FC_ASSERT( checking_asset.lottery_options->is_active );
-         FC_ASSERT( checking_asset.lottery_options->end_date != time_point_sec() );
-         if( checking_asset.lottery_options->end_date > head_block_time() ) continue;
-         checking_asset.end_lottery(*this);
-      }
+      auto itr = lotteries_idx.lower_bound( head_block_time(), lottery_asset_expiration_comparer() );
+      if( itr == lotteries_idx.end() || !itr->is_lottery() || !itr->lottery_options->is_active )
+         return;
+      FC_ASSERT( itr->lottery_options->end_date != time_point_sec() );
+      asset_object ending_asset = *itr;
+      ending_asset.end_lottery(*this);
    } catch( ... ) {}
 }
 
 void database::check_ending_nft_lotteries()
 {
    try {
-      const auto &nft_lotteries_idx = get_index_type<nft_metadata_index>().indices().get<active_nft_lotteries>();
-      for (auto checking_token : nft_lotteries_idx)
+      // Only the first lottery in active_nft_lotteries order which is either expired or sold out is ended per
+      // block. Find the expiration of that lottery from the first expired one and the sold out lotteries ending
+      // later, then pick it among the lotteries sharing this expiration.
+      const auto now = head_block_time();
+      const auto& nft_lotteries_idx = get_index_type<nft_metadata_index>().indices().get<active_nft_lotteries>();
+      optional<time_point_sec> ending_expiration;
+
+      auto expired_itr = nft_lotteries_idx.lower_bound( now, nft_lottery_expiration_comparer() );
+      if( expired_itr != nft_lotteries_idx.end() && expired_itr->is_lottery()
+          && expired_itr->lottery_data->lottery_options.is_active
+          && expired_itr->get_lottery_expiration() != time_point_sec() )
+         ending_expiration = expired_itr->get_lottery_expiration();
+
+      const auto& soldout_idx = get_index_type<nft_metadata_index>().indices().get<by_nft_lottery_soldout>();
+      for( auto itr = soldout_idx.begin(); itr != soldout_idx.end() && itr->is_active_soldout_lottery(); ++itr )
       {
-         FC_ASSERT(checking_token.is_lottery());
-         const auto &lottery_options = checking_token.lottery_data->lottery_options;
-         FC_ASSERT(lottery_options.is_active);
-         // Check the current supply of lottery tokens
-         auto current_supply = checking_token.get_token_current_supply(*this);
-         if ((lottery_options.ending_on_soldout && (current_supply == checking_token.max_supply)) ||
-             (lottery_options.end_date != time_point_sec() && (lottery_options.end_date <= head_block_time())))
-            checking_token.end_lottery(*this);
+         if( ending_expiration && itr->get_lottery_expiration() <= *ending_expiration )
+            break;
+         if( itr->get_token_current_supply(*this) == itr->max_supply )
+         {
+            ending_expiration = itr->get_lottery_expiration();
+            break;
+         }
+      }
+      if( !ending_expiration )
+         return;
+
+      for( auto itr = nft_lotteries_idx.lower_bound( *ending_expiration, nft_lottery_expiration_comparer() );
+           itr != nft_lotteries_idx.end() && itr->is_lottery() && itr->lottery_data->lottery_options.is_active
+           && itr->get_lottery_expiration() == *ending_expiration;
+           ++itr )
+      {
+         const auto& lottery_options = itr->lottery_data->lottery_options;
+         if ((lottery_options.ending_on_soldout && (itr->get_token_current_supply(*this) == itr->max_supply)) ||
+             (lottery_options.end_date != time_point_sec() && (lottery_options.end_date <= now)))
+         {
+            nft_metadata_object ending_token = *itr;
+            ending_token.end_lottery(*this);
+            return;
+         }
       }
    } catch( ... ) {}
 }
@@ -26,6 +26,7 @@
 #include <graphene/db/generic_index.hpp>
 #include <graphene/chain/protocol/account.hpp>
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/ranked_index.hpp>
 
 namespace graphene { namespace chain {
    class database;
@@ -360,6 +361,25 @@ namespace graphene { namespace chain {
          /** maps the referrer to the set of accounts that they have referred */
          map< account_id_type, set<account_id_type> > referred_by;
    };
+
+   /**
+    *  @brief This secondary index will allow a reverse lookup of all accounts that vote for a
+    *  particular vote_id, i.e. a witness, committee member, SON or worker.
+    */
+   class account_vote_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** maps a vote_id to the set of accounts that have it in their options.votes */
+         map< vote_id_type, set<account_id_type> > vote_to_voters;
+
+      protected:
+         flat_set<vote_id_type> before_votes;
+   };
    
    /**
     * @brief Tracks a pending payout of a single dividend payout asset 
@@ -430,7 +450,8 @@ namespace graphene { namespace chain {
                member<account_balance_object, asset_id_type, &account_balance_object::asset_type>
             >
          >,
-         ordered_unique< tag<by_asset_balance>,
+         // ranked so that holders of an asset can be counted and paged through in logarithmic time
+         ranked_unique< tag<by_asset_balance>,
             composite_key<
                account_balance_object,
                member<account_balance_object, asset_id_type, &account_balance_object::asset_type>,
@@ -314,6 +314,19 @@ namespace graphene { namespace chain {
       }
    };
 
+   // used to search active_lotteries by expiration, compatible with lottery_asset_comparer
+   struct lottery_asset_expiration_comparer
+   {
+      bool operator()(const asset_object& lhs, const time_point_sec& rhs) const
+      {
+         return lhs.is_lottery() && lhs.lottery_options->is_active && lhs.get_lottery_expiration() > rhs;
+      }
+      bool operator()(const time_point_sec& lhs, const asset_object& rhs) const
+      {
+         return !rhs.is_lottery() || !rhs.lottery_options->is_active || lhs > rhs.get_lottery_expiration();
+      }
+   };
+
    struct by_symbol;
    struct by_type;
    struct by_issuer;
@@ -605,6 +605,46 @@ typedef multi_index_container<
       ordered_unique< tag<by_bettor_and_odds>, identity<bet_object>, compare_bet_by_bettor_then_odds > > > bet_object_multi_index_type;
 typedef generic_index<bet_object, bet_object_multi_index_type> bet_object_index;
 
+/**
+ * Aggregates the resting bets of each betting market into price levels, one per distinct
+ * backer_multiplier on each side of the book.  Delayed bets are not part of the book until their
+ * delay expires.  Within a level, bets are matched first-in first-out in the order the by_odds
+ * index already keeps them, so the levels only track totals.
+ */
+class bet_order_book_index : public secondary_index
+{
+   public:
+      struct price_level
+      {
+         share_type amount_to_bet;
+         uint32_t   bet_count = 0;
+      };
+      /// back levels by increasing odds and lay levels by decreasing odds, so begin() is the best level to match
+      typedef std::map<bet_multiplier_type, price_level>                                        back_levels_type;
+      typedef std::map<bet_multiplier_type, price_level, std::greater<bet_multiplier_type> >   lay_levels_type;
+      struct order_book
+      {
+         back_levels_type back_levels;
+         lay_levels_type  lay_levels;
+      };
+
+      virtual void object_inserted( const object& obj ) override;
+      virtual void object_removed( const object& obj ) override;
+      virtual void about_to_modify( const object& before ) override;
+      virtual void object_modified( const object& after  ) override;
+
+      /// returns nullptr if the betting market has no resting bets
+      const order_book* get_order_book( const betting_market_id_type& betting_market_id )const;
+
+      /// true if the best level on the opposite side of the book would match the given bet's odds
+      bool has_matching_bets( const bet_object& taker_bet )const;
+
+   private:
+      void add_bet( const bet_object& bet, int64_t direction );
+
+      std::map< betting_market_id_type, order_book > _order_books;
+};
+
 struct by_bettor_betting_market{};
 struct by_betting_market_bettor{};
 typedef multi_index_container<
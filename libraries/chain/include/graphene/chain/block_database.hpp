@@ -22,17 +22,32 @@
  * THE SOFTWARE.
  */
 #pragma once
-#include <fstream>
 #include <graphene/chain/protocol/block.hpp>
 
 #include <fc/filesystem.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 namespace graphene { namespace chain {
-   class index_entry;
+   struct index_entry;
 
+   /**
+    * @brief Append-only on-disk log of blocks
+    *
+    * Blocks are appended to the "blocks" file, and the "index" file holds one fixed size entry per
+    * block number pointing into it. Both files are memory mapped for reading and all reads use
+    * positioned access without shared stream state, so the fetch methods may be called from API
+    * threads concurrently with the single thread that stores blocks. Writes are synced to disk in
+    * batches; call flush() to force outstanding writes to disk.
+    */
    class block_database 
    {
       public:
+         block_database();
+         ~block_database();
+
          void open( const fc::path& dbdir );
          bool is_open()const;
          void flush();
@@ -49,12 +64,41 @@ namespace graphene { namespace chain {
          optional<block_id_type> last_id()const;
 	 
          void set_replay_mode(bool mode);
+
+         /// Number of stored blocks after which written data is synced to disk
+         static const uint32_t blocks_per_sync = 1000;
+
       private:
+         struct mapping;
+
+         /// A file which is appended to with positioned writes and read through a memory mapping
+         struct mapped_file
+         {
+            int                             fd = -1;
+            /// Bytes which have been written completely and may be read
+            std::atomic<uint64_t>           size{0};
+            /// Current read mapping, replaced by a larger one when the file outgrows it
+            std::shared_ptr<const mapping>  map;
+
+            void open( const fc::path& filename, bool truncate );
+            void close();
+            void sync();
+            void write( uint64_t pos, const char* data, size_t len );
+            void truncate( uint64_t new_size );
+            bool read( uint64_t pos, char* out, size_t len )const;
+            void remap( uint64_t required );
+         };
+
          bool replay_mode = false;
 
+         bool read_index_entry( uint32_t block_num, index_entry& e )const;
+         optional<signed_block> read_block( const index_entry& e )const;
          optional<index_entry> last_index_entry()const;
-         fc::path _index_filename;
-         mutable std::fstream _blocks;
-         mutable std::fstream _block_num_to_pos;
+
+         mapped_file          _blocks;
+         mutable mapped_file  _block_num_to_pos;
+         /// Serializes writers; readers never take it
+         mutable std::mutex   _write_mutex;
+         uint32_t             _unsynced_blocks = 0;
    };
 } }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/types.hpp>
+#include <graphene/db/undo_database.hpp>
+
+#include <mutex>
+
+namespace graphene { namespace chain {
+
+   /**
+    *  @brief histogram of samples with power-of-two buckets
+    *
+    *  buckets[0] counts samples equal to zero and buckets[i] counts samples in [2^(i-1), 2^i), the last bucket
+    *  also counts all larger samples. Latencies are recorded in microseconds.
+    */
+   struct profile_histogram
+   {
+      static const size_t bucket_count = 32;
+
+      uint64_t         count = 0;
+      uint64_t         total = 0;
+      uint64_t         max   = 0;
+      vector<uint64_t> buckets;
+
+      void record( uint64_t value );
+   };
+
+   /// number of objects of one type created, modified and removed while applying blocks
+   struct object_change_counts
+   {
+      uint64_t created  = 0;
+      uint64_t modified = 0;
+      uint64_t removed  = 0;
+   };
+
+   /// everything recorded by the block_profiler since it was enabled or last reset
+   struct block_profile
+   {
+      uint32_t                                  first_block = 0;
+      uint32_t                                  last_block  = 0;
+      /// time spent in _apply_block, in microseconds
+      profile_histogram                         blocks;
+      /// time spent in each housekeeping phase of _apply_block, in microseconds
+      map< string, profile_histogram >          phases;
+      /// time spent evaluating each operation type including virtual operations, in microseconds
+      map< string, profile_histogram >          operations;
+      /// object changes per "space.type", taken from the undo state of each block
+      map< string, object_change_counts >       objects;
+      /// number of objects held in the undo state of each block
+      profile_histogram                         undo_state_sizes;
+   };
+
+   /**
+    *  @brief collects timing statistics while blocks are applied
+    *
+    *  The profiler is owned by the database and only exists while profiling is enabled, so that block application
+    *  does not pay for it otherwise. It may be read from other threads than the one applying blocks.
+    */
+   class block_profiler
+   {
+      public:
+         /// @param log_interval dump the profile to the log every that many blocks, 0 to never do it
+         explicit block_profiler( uint32_t log_interval );
+
+         /// start collecting the phases and operations of a block, dropping those of a block that was not applied
+         void begin_block();
+         /// phases are only added to the profile by the next record_block(), @p phase must be a string literal
+         void record_phase( const char* phase, uint64_t microseconds );
+         /// operations are only added to the profile by the next record_block(), after begin_block()
+         void record_operation( int which, uint64_t microseconds );
+         /// record a whole block, together with the object changes in its undo state if there is one
+         void record_block( uint32_t block_num, uint64_t microseconds, const graphene::db::undo_state* undo );
+
+         /// @param reset whether to start a new profile afterwards
+         block_profile get_profile( bool reset = false );
+
+      private:
+         block_profile to_profile()const;
+
+         mutable std::mutex                          _mutex;
+         uint32_t                                    _log_interval;
+         uint32_t                                    _blocks_since_log = 0;
+         uint32_t                                    _first_block = 0;
+         uint32_t                                    _last_block  = 0;
+         profile_histogram                           _blocks;
+         map< string, profile_histogram >            _phases;
+         vector< pair< const char*, uint64_t > >     _block_phases;
+         flat_map< int, profile_histogram >          _operations;
+         vector< pair< int, uint64_t > >             _block_operations;
+         map< object_id_type, object_change_counts > _objects;
+         profile_histogram                           _undo_state_sizes;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::profile_histogram, (count)(total)(max)(buckets) )
+FC_REFLECT( graphene::chain::object_change_counts, (created)(modified)(removed) )
+FC_REFLECT( graphene::chain::block_profile,
+            (first_block)(last_block)(blocks)(phases)(operations)(objects)(undo_state_sizes) )
@@ -28,6 +28,7 @@
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
+#include <graphene/chain/block_profiler.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
 
@@ -35,6 +36,7 @@
 #include <graphene/db/object.hpp>
 #include <graphene/db/simple_index.hpp>
 #include <fc/signals.hpp>
+#include <fc/thread/future.hpp>
 
 #include <fc/crypto/hash_ctr_rng.hpp>
 
@@ -44,7 +46,15 @@
 
 #include <fc/log/logger.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
+#include <future>
 #include <map>
+#include <mutex>
+#include <thread>
+
+namespace boost { namespace asio { class thread_pool; } }
 
 namespace graphene { namespace chain {
    using graphene::db::abstract_object;
@@ -102,6 +112,20 @@ namespace graphene { namespace chain {
              std::function<genesis_state_type()> genesis_loader,
              const std::string& db_version );
 
+         /**
+          * @brief Restore the object graph from a binary snapshot on the next call to @ref database::open
+          *
+          * The object database is replaced by the content of @p snapshot, which must have been written by
+          * object_database::save_snapshot(). Blocks in the block log past the snapshot's head are replayed as usual,
+          * so the block log must reach at least the snapshot's head block. Unless @p replace_existing is set, open()
+          * refuses to discard an object database that is already present.
+          */
+         void set_snapshot_to_restore( const fc::path& snapshot, bool replace_existing = false )
+         {
+            _snapshot_to_restore = snapshot;
+            _snapshot_replaces_existing = replace_existing;
+         }
+
          /**
           * @brief Rebuild object graph from block history and open detabase
           *
@@ -150,6 +174,40 @@ namespace graphene { namespace chain {
          bool _push_block( const signed_block& b );
          processed_transaction _push_transaction( const signed_transaction& trx );
 
+         /**
+          * @brief Precomputes transaction IDs and signature keys of a block in worker threads
+          *
+          * The block's transactions are split into chunks which are processed by a pool of worker
+          * threads, filling the cached @ref signed_transaction::signees and
+          * @ref processed_transaction::precomputed_id fields so that applying the block on the
+          * chain thread does not have to recover signatures serially. Work which is disabled by
+          * @p skip is not done. Errors are swallowed, they are detected again when the block is applied.
+          *
+          * @param block the block to preprocess; it must not be modified or destroyed before the
+          *              returned future is ready
+          * @param skip the skip flags which will be used when pushing the block
+          * @return a future which becomes ready when all precomputations are done
+          */
+         std::future<void> precompute_parallel( const signed_block& block, const uint32_t skip = skip_nothing )const;
+
+         /**
+          * @brief Runs the stateless checks of a batch of incoming transactions in worker threads
+          *
+          * Each transaction is validated, checked against the expiration window of the current head
+          * block, and its signature keys are recovered into the cached @ref signed_transaction::signees
+          * field, so that pushing it afterwards doesn't have to recover them on the chain thread. Must
+          * be called from the thread that pushes the transactions.
+          *
+          * @param trxs the transactions to check; they must not be modified or destroyed before the
+          *             returned future is ready
+          * @param errors resized to the number of transactions; receives the exception each failed
+          *               transaction was rejected with, the others are left empty
+          * @return a future which becomes ready when all checks are done; waiting on it yields the
+          *         calling fc thread to its other tasks
+          */
+         fc::future<void> precheck_transactions_parallel( const vector<signed_transaction>& trxs,
+                                                          vector<fc::oexception>& errors )const;
+
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
 
@@ -168,6 +226,20 @@ namespace graphene { namespace chain {
          void pop_block();
          void clear_pending();
 
+         /**
+          *  Runs a read-only callback while no block or transaction is being pushed.
+          *
+          *  push_block, push_transaction, generate_block, pop_block and clear_pending hold the chain state
+          *  exclusively, so threads other than the one pushing blocks see a consistent state from within
+          *  the callback.  The callback must not change the database.
+          */
+         template<typename Lambda>
+         auto with_read_lock( Lambda&& callback )const -> decltype( callback() )
+         {
+            boost::shared_lock<boost::shared_mutex> lock( _chain_state_mutex );
+            return callback();
+         }
+
          /**
           *  This method is used to track appied operations during the evaluation of a block, these
           *  operations should include any operation actually included in a transaction as well
@@ -512,6 +584,14 @@ namespace graphene { namespace chain {
           */
          /// Enable or disable tracking of votes of standby witnesses and committee members
          inline void enable_standby_votes_tracking(bool enable)  { _track_standby_votes = enable; }
+
+         /**
+          * Enable or disable profiling of block application.
+          * @param log_interval when enabling, dump the profile to the log every that many blocks, 0 to never do it
+          */
+         void enable_block_profiling( bool enable, uint32_t log_interval = 0 );
+         /// @return the profile recorded since profiling was enabled or last reset, empty if profiling is disabled
+         optional<block_profile> get_block_profile( bool reset = false )const;
    protected:
          //Mark pop_undo() as protected -- we do not want outside calling pop_undo(); it should call pop_block() instead
          void pop_undo() { object_database::pop_undo(); }
@@ -520,6 +600,20 @@ namespace graphene { namespace chain {
          void notify_changed_objects();
 
       private:
+         /// Holds the chain state exclusively while it is changed, nested locks on the same thread are free
+         class chain_state_write_lock
+         {
+            public:
+               explicit chain_state_write_lock( database& db );
+               ~chain_state_write_lock();
+            private:
+               database& _db;
+         };
+
+         mutable boost::shared_mutex            _chain_state_mutex;
+         std::atomic<std::thread::id>           _chain_state_writer{ std::thread::id() };
+         uint32_t                               _chain_state_write_depth = 0;
+
          std::mutex                             _pending_tx_session_mutex;
          optional<undo_database::session>       _pending_tx_session;
          vector< unique_ptr<op_evaluator> >     _operation_evaluators;
@@ -539,7 +633,10 @@ namespace graphene { namespace chain {
          operation_result      apply_operation( transaction_evaluation_state& eval_state, const operation& op );
       private:
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx );
+         processed_transaction _apply_transaction( const signed_transaction& trx,
+                                                   const optional<transaction_id_type>& precomputed_id = optional<transaction_id_type>() );
+         void                  _precompute_parallel( const processed_transaction* trx, size_t count, uint32_t skip )const;
+         boost::asio::thread_pool& precompute_pool()const;
       
          ///Steps involved in applying a new block
          ///@{
@@ -648,6 +745,31 @@ namespace graphene { namespace chain {
 
          node_property_object              _node_property_object;
 
+         optional<fc::path>                _snapshot_to_restore;
+         bool                              _snapshot_replaces_existing = false;
+
+         /// Worker threads used by precompute_parallel() and the replay pipeline, created on first use
+         mutable std::unique_ptr<boost::asio::thread_pool> _precompute_pool;
+         mutable std::once_flag                            _precompute_pool_created;
+         mutable size_t                                    _precompute_pool_size = 0;
+
+         /// Block application statistics, only allocated while profiling is enabled
+         std::unique_ptr<block_profiler>   _block_profiler;
+
+         /// Run a phase of _apply_block, timing it if profiling is enabled
+         template<typename Lambda>
+         void profile_phase( const char* phase, Lambda&& callback )
+         {
+            if( !_block_profiler )
+            {
+               callback();
+               return;
+            }
+            auto start = fc::time_point::now();
+            callback();
+            _block_profiler->record_phase( phase, ( fc::time_point::now() - start ).count() );
+         }
+
          /// Whether to update votes of standby witnesses and committee members when performing chain maintenance.
          /// Set it to true to provide accurate data to API clients, set to false to have better performance.
          bool                              _track_standby_votes = true;
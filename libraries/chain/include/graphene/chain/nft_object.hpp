@@ -49,6 +49,7 @@ namespace graphene { namespace chain {
 
          nft_metadata_id_type get_id() const { return id; }
          bool is_lottery() const { return lottery_data.valid(); }
+         bool is_active_soldout_lottery() const { return is_lottery() && lottery_data->lottery_options.is_active && lottery_data->lottery_options.ending_on_soldout; }
          uint32_t get_owner_num() const { return owner.instance.value; }
          time_point_sec get_lottery_expiration() const;
          asset get_lottery_jackpot(const database &db) const;
@@ -86,11 +87,25 @@ namespace graphene { namespace chain {
       }
    };
 
+   // used to search active_nft_lotteries by expiration, compatible with nft_lottery_comparer
+   struct nft_lottery_expiration_comparer
+   {
+      bool operator()(const nft_metadata_object& lhs, const time_point_sec& rhs) const
+      {
+         return lhs.is_lottery() && lhs.lottery_data->lottery_options.is_active && lhs.get_lottery_expiration() > rhs;
+      }
+      bool operator()(const time_point_sec& lhs, const nft_metadata_object& rhs) const
+      {
+         return !rhs.is_lottery() || !rhs.lottery_data->lottery_options.is_active || lhs > rhs.get_lottery_expiration();
+      }
+   };
+
    struct by_name;
    struct by_symbol;
    struct active_nft_lotteries;
    struct by_nft_lottery;
    struct by_nft_lottery_owner;
+   struct by_nft_lottery_soldout;
    using nft_metadata_multi_index_type = multi_index_container<
       nft_metadata_object,
       indexed_by<
@@ -133,6 +148,17 @@ namespace graphene { namespace chain {
          >,
          ordered_non_unique< tag<by_owner>,
             member<nft_metadata_object, account_id_type, &nft_metadata_object::owner>
+         >,
+         ordered_non_unique< tag<by_nft_lottery_soldout>,
+            composite_key<
+               nft_metadata_object,
+               const_mem_fun<nft_metadata_object, bool, &nft_metadata_object::is_active_soldout_lottery>,
+               const_mem_fun<nft_metadata_object, time_point_sec, &nft_metadata_object::get_lottery_expiration>
+            >,
+            composite_key_compare<
+               std::greater< bool >,
+               std::greater< time_point_sec >
+            >
          >
       >
    >;
@@ -170,6 +196,25 @@ namespace graphene { namespace chain {
    >;
    using nft_index = generic_index<nft_object, nft_multi_index_type>;
 
+   /**
+    *  @brief This secondary index keeps the number of tokens minted for each nft_metadata_object, so that
+    *  the current supply of a lottery does not have to be counted from nft_index on every block.
+    */
+   class nft_supply_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** @return number of nft_objects referring to the given metadata */
+         share_type get_supply( nft_metadata_id_type metadata_id )const;
+
+      private:
+         map< nft_metadata_id_type, share_type > supply;
+   };
+
    using nft_lottery_balance_index_type = multi_index_container<
       nft_lottery_balance_object,
       indexed_by<
@@ -230,6 +230,12 @@ namespace graphene { namespace chain {
       vector<operation_result> operation_results;
 
       digest_type merkle_digest()const;
+
+      /**
+       * Transaction ID filled in by @ref database::precompute_parallel before the containing block is applied.
+       * Not serialized; it is only trusted while the transaction is not modified after precomputation.
+       */
+      mutable optional<transaction_id_type> precomputed_id;
    };
 
    /// @} transactions group
@@ -237,7 +243,7 @@ namespace graphene { namespace chain {
 } } // graphene::chain
 
 FC_REFLECT( graphene::chain::transaction, (ref_block_num)(ref_block_prefix)(expiration)(operations)(extensions) )
-// Note: not reflecting signees field for backward compatibility; in addition, it should not be in p2p messages
+// Note: not reflecting signees and precomputed_id fields for backward compatibility; in addition, they should not be in p2p messages
 FC_REFLECT_DERIVED( graphene::chain::signed_transaction, (graphene::chain::transaction), (signatures) )
 FC_REFLECT_DERIVED( graphene::chain::processed_transaction, (graphene::chain::signed_transaction), (operation_results) )
 
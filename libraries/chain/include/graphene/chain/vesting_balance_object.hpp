@@ -242,6 +242,36 @@ namespace graphene { namespace chain {
     */
    typedef generic_index<vesting_balance_object, vesting_balance_multi_index_type> vesting_balance_index;
 
+   /**
+    *  @brief This secondary index keeps, for each vesting_balance_type, the total core asset vesting balance of
+    *  every account up to date, so that vote tallying does not need to rebuild it at each maintenance interval.
+    */
+   class vesting_balance_stake_index : public secondary_index
+   {
+      public:
+         struct stake
+         {
+            share_type amount;
+            /** number of vesting balance objects summed into amount; an account may have zero-amount balances */
+            uint32_t   balance_count = 0;
+         };
+         typedef map< account_id_type, stake > stake_map;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** @return per-account core vesting totals of the given balance type */
+         const stake_map& get_core_stakes( vesting_balance_type type )const;
+
+      private:
+         void add( const vesting_balance_object& vbo );
+         void subtract( const vesting_balance_object& vbo );
+
+         map< vesting_balance_type, stake_map > core_stakes;
+   };
+
 } } // graphene::chain
 
 FC_REFLECT(graphene::chain::linear_vesting_policy,
@@ -21,11 +21,8 @@ namespace graphene
 
         share_type nft_metadata_object::get_token_current_supply(const database &db) const
         {
-            share_type current_supply;
-            const auto &idx_lottery_by_md = db.get_index_type<nft_index>().indices().get<by_metadata>();
-            auto lottery_range = idx_lottery_by_md.equal_range(id);
-            current_supply = std::distance(lottery_range.first, lottery_range.second);
-            return current_supply;
+            const auto &supply_idx = db.get_index_type<primary_index<nft_index>>().get_secondary_index<nft_supply_index>();
+            return supply_idx.get_supply(id);
         }
 
         vector<account_id_type> nft_metadata_object::get_holders(const database &db) const
@@ -167,5 +164,34 @@ namespace graphene
             end_op.lottery_id = get_id();
             db.apply_operation(eval, end_op);
         }
+
+        void nft_supply_index::object_inserted(const object &obj)
+        {
+            ++supply[static_cast<const nft_object &>(obj).nft_metadata_id];
+        }
+
+        void nft_supply_index::object_removed(const object &obj)
+        {
+            auto itr = supply.find(static_cast<const nft_object &>(obj).nft_metadata_id);
+            FC_ASSERT(itr != supply.end() && itr->second > 0);
+            if (--itr->second == 0)
+                supply.erase(itr);
+        }
+
+        void nft_supply_index::about_to_modify(const object &before)
+        {
+            object_removed(before);
+        }
+
+        void nft_supply_index::object_modified(const object &after)
+        {
+            object_inserted(after);
+        }
+
+        share_type nft_supply_index::get_supply(nft_metadata_id_type metadata_id) const
+        {
+            auto itr = supply.find(metadata_id);
+            return itr == supply.end() ? share_type() : itr->second;
+        }
     } // namespace chain
 } // namespace graphene
@@ -276,6 +276,54 @@ asset vesting_balance_object::get_allowed_withdraw(const time_point_sec& now)con
    return policy.visit(get_allowed_withdraw_visitor(balance, now, amount));
 }
 
+void vesting_balance_stake_index::object_inserted( const object& obj )
+{
+   add( static_cast<const vesting_balance_object&>( obj ) );
+}
+
+void vesting_balance_stake_index::object_removed( const object& obj )
+{
+   subtract( static_cast<const vesting_balance_object&>( obj ) );
+}
+
+void vesting_balance_stake_index::about_to_modify( const object& before )
+{
+   subtract( static_cast<const vesting_balance_object&>( before ) );
+}
+
+void vesting_balance_stake_index::object_modified( const object& after )
+{
+   add( static_cast<const vesting_balance_object&>( after ) );
+}
+
+const vesting_balance_stake_index::stake_map& vesting_balance_stake_index::get_core_stakes( vesting_balance_type type )const
+{
+   static const stake_map empty;
+   auto itr = core_stakes.find( type );
+   return itr == core_stakes.end() ? empty : itr->second;
+}
+
+void vesting_balance_stake_index::add( const vesting_balance_object& vbo )
+{
+   if( vbo.balance.asset_id != asset_id_type() )
+      return;
+   auto& entry = core_stakes[vbo.balance_type][vbo.owner];
+   entry.amount += vbo.balance.amount;
+   ++entry.balance_count;
+}
+
+void vesting_balance_stake_index::subtract( const vesting_balance_object& vbo )
+{
+   if( vbo.balance.asset_id != asset_id_type() )
+      return;
+   auto& stakes = core_stakes[vbo.balance_type];
+   auto itr = stakes.find( vbo.owner );
+   FC_ASSERT( itr != stakes.end() && itr->second.balance_count > 0 );
+   itr->second.amount -= vbo.balance.amount;
+   if( --itr->second.balance_count == 0 )
+      stakes.erase( itr );
+}
+
 } } // graphene::chain
 
 GRAPHENE_EXTERNAL_SERIALIZATION( /*not extern*/, graphene::chain::linear_vesting_policy )
@@ -98,6 +98,18 @@ namespace graphene { namespace db {
          virtual void open( const fc::path& db ) = 0;
          virtual void save( const fc::path& db ) = 0;
 
+         /**
+          *  Serializes the whole index (next id, version and every object) into a self contained
+          *  section of an object_database snapshot.  Must not modify the index, so that several
+          *  indexes can be serialized concurrently.
+          */
+         virtual void save_section( std::vector<char>& out )const = 0;
+         /**
+          *  Loads a section produced by save_section() into an empty index.  Only this index and its
+          *  secondary indexes are touched, so that several indexes can be loaded concurrently.
+          */
+         virtual void load_section( const char* data, size_t size ) = 0;
+
 
 
          /** @return the object with id or nullptr if not found */
@@ -376,6 +388,57 @@ namespace graphene { namespace db {
             });
          }
 
+         virtual void save_section( std::vector<char>& out )const override
+         {
+            const auto ver = get_object_version();
+            uint64_t count = 0;
+            fc::datastream<size_t> sizer;
+            fc::raw::pack( sizer, _next_id );
+            fc::raw::pack( sizer, ver );
+            fc::raw::pack( sizer, count );
+            this->inspect_all_objects( [&]( const object& o ) {
+               fc::raw::pack( sizer, static_cast<const object_type&>(o) );
+               ++count;
+            });
+
+            out.resize( sizer.tellp() );
+            fc::datastream<char*> ds( out.data(), out.size() );
+            fc::raw::pack( ds, _next_id );
+            fc::raw::pack( ds, ver );
+            fc::raw::pack( ds, count );
+            this->inspect_all_objects( [&]( const object& o ) {
+               fc::raw::pack( ds, static_cast<const object_type&>(o) );
+            });
+         }
+
+         virtual void load_section( const char* data, size_t size )override
+         {
+            fc::datastream<const char*> ds( data, size );
+            fc::sha256 open_ver;
+            uint64_t count;
+            fc::raw::unpack( ds, _next_id );
+            fc::raw::unpack( ds, open_ver );
+            FC_ASSERT( open_ver == get_object_version(), "Incompatible Version, the serialization of objects in this index has changed" );
+            fc::raw::unpack( ds, count );
+            for( uint64_t i = 0; i < count; ++i )
+            {
+               object_type obj;
+               fc::raw::unpack( ds, obj );
+               const auto& result = DerivedIndex::insert( std::move(obj) );
+               for( const auto& item : _sindex )
+                  item->object_inserted( result );
+            }
+            FC_ASSERT( ds.remaining() == 0, "Trailing data in object_database snapshot section" );
+         }
+
+         virtual const object&  insert( object&& obj )override
+         {
+            const auto& result = DerivedIndex::insert( std::move( obj ) );
+            for( const auto& item : _sindex )
+               item->object_inserted( result );
+            return result;
+         }
+
          virtual const object&  load( const std::vector<char>& data )override
          {
             const auto& result = DerivedIndex::insert( fc::raw::unpack<object_type>( data ) );
@@ -75,6 +75,8 @@ namespace graphene { namespace db {
          /// these methods are implemented for derived classes by inheriting abstract_object<DerivedClass>
          virtual unique_ptr<object> clone()const = 0;
          virtual void               move_from( object& obj ) = 0;
+         /// assign a copy of obj, which must be of the same type, reusing the storage already owned by this object
+         virtual void               copy_from( const object& obj ) = 0;
          virtual variant            to_variant()const  = 0;
          virtual vector<char>       pack()const = 0;
          virtual fc::uint128        hash()const = 0;
@@ -100,6 +102,10 @@ namespace graphene { namespace db {
          {
             static_cast<DerivedClass&>(*this) = std::move( static_cast<DerivedClass&>(obj) );
          }
+         virtual void    copy_from( const object& obj )
+         {
+            static_cast<DerivedClass&>(*this) = static_cast<const DerivedClass&>(obj);
+         }
          virtual variant to_variant()const { return variant( static_cast<const DerivedClass&>(*this), MAX_NESTING ); }
          virtual vector<char> pack()const  { return fc::raw::pack( static_cast<const DerivedClass&>(*this) ); }
          virtual fc::uint128  hash()const  {  
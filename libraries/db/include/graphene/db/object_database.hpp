@@ -52,6 +52,17 @@ namespace graphene { namespace db {
           */
          void flush();
          void wipe(const fc::path& data_dir); // remove from disk
+
+         /**
+          * Writes every index into a single binary snapshot file.  Indexes are serialized in parallel and
+          * each section carries a checksum so that a damaged snapshot is detected on load.
+          */
+         void save_snapshot( const fc::path& filename )const;
+         /**
+          * Loads a snapshot written by save_snapshot() into the (empty) registered indexes, loading
+          * independent indexes in parallel.  Sections for indexes that are not registered are skipped.
+          */
+         void load_snapshot( const fc::path& filename );
          void close();
 
          template<typename T, typename F>
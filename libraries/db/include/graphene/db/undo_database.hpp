@@ -24,6 +24,7 @@
 #pragma once
 #include <graphene/db/object.hpp>
 #include <deque>
+#include <typeindex>
 #include <fc/exception/exception.hpp>
 
 namespace graphene { namespace db {
@@ -127,11 +128,26 @@ namespace graphene { namespace db {
          void merge();
          void commit();
 
+         /// copy obj into a recycled object of the same type if one is available, otherwise clone it
+         unique_ptr<object> save_copy( const object& obj );
+         /// keep an object saved by save_copy() which is no longer needed so that it can be reused
+         void recycle( unique_ptr<object>&& obj );
+         /// recycle all objects saved in a state which is about to be discarded
+         void recycle( undo_state& state );
+
          uint32_t                _active_sessions = 0;
          bool                    _disabled = true;
          std::deque<undo_state>  _stack;
          object_database&        _db;
          size_t                  _max_size = 256;
+
+         /**
+          * Saved copies of objects from discarded undo states, by object type. Every block saves and later
+          * discards about the same objects, so reusing them saves an allocation per modified object as well
+          * as the reallocation of the containers they hold.
+          */
+         std::unordered_map< std::type_index, vector< unique_ptr<object> > > _object_pool;
+         size_t                  _max_pooled_objects_per_type = 1024;
    };
 
 } } // graphene::db
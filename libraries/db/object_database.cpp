@@ -27,6 +27,41 @@
 #include <fc/container/flat.hpp>
 #include <fc/uint128.hpp>
 
+#include <fstream>
+#include <future>
+
+namespace graphene { namespace db { namespace detail {
+
+   /**
+    *  Layout of the binary snapshot: a header, a table of sections and then the sections themselves,
+    *  one per index.  Table entries have a fixed packed size so the table can be sized before the
+    *  offsets are known.
+    */
+   struct snapshot_header
+   {
+      static const uint64_t magic_value   = 0x544f4853504e5347ull; // "GSNPSHOT"
+      static const uint32_t current_version = 1;
+
+      uint64_t magic   = magic_value;
+      uint32_t version = current_version;
+   };
+
+   struct snapshot_section
+   {
+      uint8_t     space    = 0;
+      uint8_t     type     = 0;
+      uint64_t    offset   = 0;
+      uint64_t    size     = 0;
+      fc::sha256  checksum;
+   };
+
+   static const char* const snapshot_file_name = "snapshot.bin";
+
+} } } // graphene::db::detail
+
+FC_REFLECT( graphene::db::detail::snapshot_header, (magic)(version) )
+FC_REFLECT( graphene::db::detail::snapshot_section, (space)(type)(offset)(size)(checksum) )
+
 namespace graphene { namespace db {
 
 object_database::object_database()
@@ -72,14 +107,7 @@ void object_database::flush()
 {
 //   ilog("Save object_database in ${d}", ("d", _data_dir));
    fc::create_directories( _data_dir / "object_database.tmp" / "lock" );
-   for( uint32_t space = 0; space < _index.size(); ++space )
-   {
-      fc::create_directories( _data_dir / "object_database.tmp" / fc::to_string(space) );
-      const auto types = _index[space].size();
-      for( uint32_t type = 0; type  <  types; ++type )
-         if( _index[space][type] )
-            _index[space][type]->save( _data_dir / "object_database.tmp" / fc::to_string(space)/fc::to_string(type) );
-   }
+   save_snapshot( _data_dir / "object_database.tmp" / detail::snapshot_file_name );
    fc::remove_all( _data_dir / "object_database.tmp" / "lock" );
    if( fc::exists( _data_dir / "object_database" ) )
       fc::rename( _data_dir / "object_database", _data_dir / "object_database.old" );
@@ -104,6 +132,13 @@ void object_database::open(const fc::path& data_dir)
        return;
    }
    ilog("Opening object database from ${d} ...", ("d", data_dir));
+   if( fc::exists( _data_dir / "object_database" / detail::snapshot_file_name ) )
+   {
+      load_snapshot( _data_dir / "object_database" / detail::snapshot_file_name );
+      ilog( "Done opening object database." );
+      return;
+   }
+   // databases written before the snapshot format keep one file per index
    for( uint32_t space = 0; space < _index.size(); ++space )
       for( uint32_t type = 0; type  < _index[space].size(); ++type )
          if( _index[space][type] )
@@ -112,6 +147,98 @@ void object_database::open(const fc::path& data_dir)
 
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
+void object_database::save_snapshot( const fc::path& filename )const
+{ try {
+   vector<const index*> indexes;
+   for( const auto& space : _index )
+      for( const auto& idx : space )
+         if( idx )
+            indexes.push_back( idx.get() );
+
+   vector< vector<char> > data( indexes.size() );
+   vector< std::future<void> > pending;
+   pending.reserve( indexes.size() );
+   for( size_t i = 0; i < indexes.size(); ++i )
+      pending.push_back( std::async( std::launch::async, [&indexes,&data,i]() {
+         indexes[i]->save_section( data[i] );
+      }));
+   for( auto& f : pending )
+      f.get();
+
+   detail::snapshot_header header;
+   vector<detail::snapshot_section> sections( indexes.size() );
+   uint64_t offset = fc::raw::pack_size( header ) + fc::raw::pack_size( sections );
+   for( size_t i = 0; i < indexes.size(); ++i )
+   {
+      auto& section = sections[i];
+      section.space    = indexes[i]->object_space_id();
+      section.type     = indexes[i]->object_type_id();
+      section.offset   = offset;
+      section.size     = data[i].size();
+      section.checksum = fc::sha256::hash( data[i].data(), data[i].size() );
+      offset += section.size;
+   }
+
+   std::ofstream out( filename.generic_string(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc );
+   FC_ASSERT( out, "Unable to create snapshot file" );
+   fc::raw::pack( out, header );
+   fc::raw::pack( out, sections );
+   for( const auto& d : data )
+      out.write( d.data(), d.size() );
+   out.flush();
+   FC_ASSERT( out, "Error while writing snapshot file" );
+} FC_CAPTURE_AND_RETHROW( (filename) ) }
+
+void object_database::load_snapshot( const fc::path& filename )
+{ try {
+   const auto file_size = fc::file_size( filename );
+   fc::file_mapping fm( filename.generic_string().c_str(), fc::read_only );
+   fc::mapped_region mr( fm, fc::read_only, 0, file_size );
+   const char* base = (const char*)mr.get_address();
+
+   fc::datastream<const char*> ds( base, file_size );
+   detail::snapshot_header header;
+   vector<detail::snapshot_section> sections;
+   fc::raw::unpack( ds, header );
+   FC_ASSERT( header.magic == detail::snapshot_header::magic_value, "Not an object_database snapshot" );
+   FC_ASSERT( header.version == detail::snapshot_header::current_version,
+              "Unsupported snapshot version", ("version",header.version) );
+   fc::raw::unpack( ds, sections );
+
+   vector< std::future<void> > pending;
+   pending.reserve( sections.size() );
+   for( const auto& section : sections )
+   {
+      FC_ASSERT( section.offset <= file_size && section.size <= file_size - section.offset,
+                 "Snapshot section is out of bounds", ("space",section.space)("type",section.type) );
+      if( _index.size() <= section.space || _index[section.space].size() <= section.type
+          || !_index[section.space][section.type] )
+      {
+         wlog( "Skipping snapshot section of unknown index ${s}.${t}", ("s",section.space)("t",section.type) );
+         continue;
+      }
+      index* idx = _index[section.space][section.type].get();
+      const char* data = base + section.offset;
+      pending.push_back( std::async( std::launch::async, [idx,data,&section]() {
+         FC_ASSERT( fc::sha256::hash( data, section.size ) == section.checksum,
+                    "Snapshot section checksum mismatch", ("space",section.space)("type",section.type) );
+         idx->load_section( data, section.size );
+      }));
+   }
+   // wait for every loader before reporting the first failure, they all reference the mapping
+   std::exception_ptr error;
+   for( auto& f : pending )
+   {
+      try {
+         f.get();
+      } catch( ... ) {
+         if( !error )
+            error = std::current_exception();
+      }
+   }
+   if( error )
+      std::rethrow_exception( error );
+} FC_CAPTURE_AND_RETHROW( (filename) ) }
 
 void object_database::pop_undo()
 { try {
@@ -134,3 +261,4 @@ void object_database::save_undo_remove(const object& obj)
 }
 
 } } // namespace graphene::db
+
@@ -50,9 +50,18 @@ undo_database::session undo_database::start_undo_session( bool force_enable )
       _disabled = false;
 
    while( size() > max_size() )
+   {
+      recycle( _stack.front() );
       _stack.pop_front();
+   }
 
    _stack.emplace_back();
+   if( _stack.size() > 1 )
+   {
+      // blocks tend to touch a similar number of objects, avoid rehashing while the state grows
+      const auto& prev_state = _stack[_stack.size() - 2];
+      _stack.back().old_values.reserve( prev_state.old_values.size() );
+   }
    ++_active_sessions;
    return session(*this, disable_on_exit );
 }
@@ -80,7 +89,7 @@ void undo_database::on_modify( const object& obj )
       return;
    auto itr =  state.old_values.find(obj.id);
    if( itr != state.old_values.end() ) return;
-   state.old_values[obj.id] = obj.clone();
+   state.old_values.emplace( obj.id, save_copy( obj ) );
 }
 void undo_database::on_remove( const object& obj )
 {
@@ -89,19 +98,17 @@ void undo_database::on_remove( const object& obj )
    if( _stack.empty() )
       _stack.emplace_back();
    undo_state& state = _stack.back();
-   if( state.new_ids.count(obj.id) )
-   {
-      state.new_ids.erase(obj.id);
+   if( state.new_ids.erase(obj.id) )
       return;
-   }
-   if( state.old_values.count(obj.id) )
+   auto itr = state.old_values.find(obj.id);
+   if( itr != state.old_values.end() )
    {
-      state.removed[obj.id] = std::move(state.old_values[obj.id]);
-      state.old_values.erase(obj.id);
+      state.removed[obj.id] = std::move(itr->second);
+      state.old_values.erase(itr);
       return;
    }
    if( state.removed.count(obj.id) ) return;
-   state.removed[obj.id] = obj.clone();
+   state.removed.emplace( obj.id, save_copy( obj ) );
 }
 
 void undo_database::undo()
@@ -129,6 +136,7 @@ void undo_database::undo()
    for( auto& item : state.removed )
       _db.insert( std::move(*item.second) );
 
+   recycle( state );
    _stack.pop_back();
    enable();
    --_active_sessions;
@@ -139,6 +147,7 @@ void undo_database::merge()
    FC_ASSERT( _active_sessions > 0 );
    if( _active_sessions == 1 && _stack.size() == 1 )
    {
+      recycle( _stack.back() );
       _stack.pop_back();
       --_active_sessions;
       return;
@@ -195,11 +204,13 @@ void undo_database::merge()
       if( prev_state.new_ids.find(obj.second->id) != prev_state.new_ids.end() )
       {
          // new+upd -> new, type A
+         recycle( std::move(obj.second) );
          continue;
       }
       if( prev_state.old_values.find(obj.second->id) != prev_state.old_values.end() )
       {
          // upd(was=X) + upd(was=Y) -> upd(was=X), type A
+         recycle( std::move(obj.second) );
          continue;
       }
       // del+upd -> N/A
@@ -236,6 +247,7 @@ void undo_database::merge()
       {
          // new + del -> nop (type C)
          prev_state.new_ids.erase(obj.second->id);
+         recycle( std::move(obj.second) );
          continue;
       }
       auto it = prev_state.old_values.find(obj.second->id);
@@ -243,7 +255,8 @@ void undo_database::merge()
       {
          // upd(was=X) + del(was=Y) -> del(was=X)
          prev_state.removed[obj.second->id] = std::move(it->second);
-         prev_state.old_values.erase(obj.second->id);
+         prev_state.old_values.erase(it);
+         recycle( std::move(obj.second) );
          continue;
       }
       // del + del -> N/A
@@ -287,6 +300,7 @@ void undo_database::pop_commit()
       for( auto& item : state.removed )
          _db.insert( std::move(*item.second) );
 
+      recycle( state );
       _stack.pop_back();
    }
    catch ( const fc::exception& e )
@@ -297,6 +311,36 @@ void undo_database::pop_commit()
    }
    enable();
 }
+unique_ptr<object> undo_database::save_copy( const object& obj )
+{
+   auto itr = _object_pool.find( std::type_index( typeid(obj) ) );
+   if( itr == _object_pool.end() || itr->second.empty() )
+      return obj.clone();
+   unique_ptr<object> result = std::move( itr->second.back() );
+   itr->second.pop_back();
+   result->copy_from( obj );
+   return result;
+}
+
+void undo_database::recycle( unique_ptr<object>&& obj )
+{
+   if( !obj )
+      return;
+   auto& pool = _object_pool[ std::type_index( typeid(*obj) ) ];
+   if( pool.size() < _max_pooled_objects_per_type )
+      pool.emplace_back( std::move(obj) );
+   else
+      obj.reset();
+}
+
+void undo_database::recycle( undo_state& state )
+{
+   for( auto& item : state.old_values )
+      recycle( std::move(item.second) );
+   for( auto& item : state.removed )
+      recycle( std::move(item.second) );
+}
+
 const undo_state& undo_database::head()const
 {
    FC_ASSERT( !_stack.empty() );
@@ -23,6 +23,8 @@
  */
 #include <graphene/net/core_messages.hpp>
 
+#include <fc/io/raw.hpp>
+
 
 namespace graphene { namespace net {
 
@@ -45,5 +47,23 @@ namespace graphene { namespace net {
   const core_message_type_enum check_firewall_reply_message::type            = core_message_type_enum::check_firewall_reply_message_type;
   const core_message_type_enum get_current_connections_request_message::type = core_message_type_enum::get_current_connections_request_message_type;
   const core_message_type_enum get_current_connections_reply_message::type   = core_message_type_enum::get_current_connections_reply_message_type;
+  const core_message_type_enum compact_block_message::type                   = core_message_type_enum::compact_block_message_type;
+  const core_message_type_enum fetch_block_transactions_message::type        = core_message_type_enum::fetch_block_transactions_message_type;
+  const core_message_type_enum block_transactions_message::type              = core_message_type_enum::block_transactions_message_type;
+
+  item_hash_t get_trx_message_id( const signed_transaction& trx )
+  {
+    // a trx_message serializes to exactly its transaction, so hash that directly
+    return fc::ripemd160::hash( trx );
+  }
+
+  compact_block_message::compact_block_message(const item_hash_t& item_hash, const signed_block& block) :
+    item_hash(item_hash),
+    header(block)
+  {
+    transactions.reserve(block.transactions.size());
+    for (const graphene::chain::processed_transaction& transaction : block.transactions)
+      transactions.push_back(compact_transaction{get_trx_message_id(transaction), transaction.operation_results});
+  }
 
 } } // graphene::net
@@ -85,6 +85,14 @@
 #define GRAPHENE_NET_MAX_INVENTORY_SIZE_IN_MINUTES           2
 
 #define GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING      200
+#define GRAPHENE_NET_MIN_BLOCKS_PER_PEER_DURING_SYNCING      10
+
+/**
+ * During sync, each peer is asked for roughly as many blocks as it delivered in this many
+ * seconds in its previous batches (between the min and max blocks per peer above), so slow
+ * peers get short ranges and don't hold up applying the blocks behind them.
+ */
+#define GRAPHENE_NET_SYNC_BATCH_TARGET_DURATION_SEC          5
 
 /**
  * During normal operation, how many items will be fetched from each
@@ -109,6 +117,13 @@
 
 #define GRAPHENE_NET_MAX_TRX_PER_SECOND                      1000
 
+/**
+ * Transactions received from peers are handed to the client in batches so their
+ * signatures can be checked in parallel.  A batch takes at most this many transactions
+ * from any one peer, so a peer flooding us can't delay the transactions of the others.
+ */
+#define GRAPHENE_NET_MAX_TRX_PER_PEER_PER_BATCH              50
+
 #define GRAPHENE_NET_MAX_NESTED_OBJECTS                      (250)
 
 #define MAXIMUM_PEERDB_SIZE 1000
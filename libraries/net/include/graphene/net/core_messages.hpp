@@ -86,6 +86,9 @@ namespace graphene { namespace net {
     check_firewall_reply_message_type            = 5015,
     get_current_connections_request_message_type = 5016,
     get_current_connections_reply_message_type   = 5017,
+    compact_block_message_type                   = 5018,
+    fetch_block_transactions_message_type        = 5019,
+    block_transactions_message_type              = 5020,
     core_message_type_last                       = 5099
   };
 
@@ -115,6 +118,61 @@ namespace graphene { namespace net {
 
    };
 
+  /** the id of the trx_message that carries @p trx, computed without building the message */
+  item_hash_t get_trx_message_id( const signed_transaction& trx );
+
+  struct compact_transaction
+  {
+    item_hash_t                                  message_id; /// id of the trx_message the transaction was relayed in
+    std::vector<graphene::chain::operation_result> operation_results;
+  };
+
+  /**
+   * Sent in place of a block_message to peers that negotiated compact blocks in their hello.
+   * Transactions are referenced by the id of their trx_message, so the receiver can rebuild
+   * the block from the transactions in its own message cache and only has to fetch the
+   * ones it has not seen (see fetch_block_transactions_message).
+   */
+  struct compact_block_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                          item_hash; /// hash of the block_message that was requested
+    graphene::chain::signed_block_header header;
+    std::vector<compact_transaction>     transactions;
+
+    compact_block_message() {}
+    compact_block_message(const item_hash_t& item_hash, const signed_block& block);
+  };
+
+  struct fetch_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t           item_hash; /// hash of the block_message the transactions are in
+    std::vector<uint32_t> transaction_indices;
+
+    fetch_block_transactions_message() {}
+    fetch_block_transactions_message(const item_hash_t& item_hash, const std::vector<uint32_t>& transaction_indices) :
+      item_hash(item_hash),
+      transaction_indices(transaction_indices)
+    {}
+  };
+
+  struct block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                     item_hash;
+    std::vector<signed_transaction> transactions; /// in the order of the requested transaction_indices
+
+    block_transactions_message() {}
+    block_transactions_message(const item_hash_t& item_hash, std::vector<signed_transaction> transactions) :
+      item_hash(item_hash),
+      transactions(std::move(transactions))
+    {}
+  };
+
   struct item_ids_inventory_message
   {
     static const core_message_type_enum type;
@@ -424,10 +482,17 @@ FC_REFLECT_ENUM( graphene::net::core_message_type_enum,
                  (check_firewall_reply_message_type)
                  (get_current_connections_request_message_type)
                  (get_current_connections_reply_message_type)
+                 (compact_block_message_type)
+                 (fetch_block_transactions_message_type)
+                 (block_transactions_message_type)
                  (core_message_type_last) )
 
 FC_REFLECT( graphene::net::trx_message, (trx) )
 FC_REFLECT( graphene::net::block_message, (block)(block_id) )
+FC_REFLECT( graphene::net::compact_transaction, (message_id)(operation_results) )
+FC_REFLECT( graphene::net::compact_block_message, (item_hash)(header)(transactions) )
+FC_REFLECT( graphene::net::fetch_block_transactions_message, (item_hash)(transaction_indices) )
+FC_REFLECT( graphene::net::block_transactions_message, (item_hash)(transactions) )
 
 FC_REFLECT( graphene::net::item_id, (item_type)
                                (item_hash) )
@@ -33,6 +33,8 @@
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/reflect/typename.hpp>
 
+#include <memory>
+
 namespace graphene { namespace net {
 
   /**
@@ -112,6 +114,13 @@ namespace graphene { namespace net {
      }
   };
 
+  /**
+   *  An immutable, reference-counted message.  Messages that go to many peers (blocks and
+   *  transactions from the message cache) are packed once and shared by every send queue
+   *  instead of being copied per peer.
+   */
+  typedef std::shared_ptr<const message> message_ptr;
+
 } } // graphene::net
 
 FC_REFLECT( graphene::net::message_header, (size)(msg_type) )
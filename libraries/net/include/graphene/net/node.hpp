@@ -81,6 +81,16 @@ namespace graphene { namespace net {
           */
          virtual bool handle_block( const graphene::net::block_message& blk_msg, bool sync_mode, 
                                     std::vector<fc::uint160_t>& contained_transaction_message_ids ) = 0;
+
+         /**
+          *  @brief Called when a sync block arrives from the network, before it is queued for handle_block()
+          *
+          *  Allows the delegate to start stateless preprocessing of the block (e.g. signature
+          *  recovery) in the background while earlier blocks are still being applied.
+          *
+          *  @param blk_msg the message which contains the block
+          */
+         virtual void prefetch_block( const graphene::net::block_message& blk_msg ) {}
          
          /**
           *  @brief Called when a new transaction comes in from the network
@@ -90,6 +100,37 @@ namespace graphene { namespace net {
           */
          virtual void handle_transaction( const graphene::net::trx_message& trx_msg ) = 0;
 
+         /**
+          *  @brief Called with a batch of new transactions from the network, in the order they
+          *         should be applied
+          *
+          *  Lets the delegate run the stateless checks of the whole batch in parallel.  The
+          *  default implementation calls handle_transaction() for each of them.
+          *
+          *  @returns for each transaction, the exception it was rejected with; transactions
+          *           without one are safe to broadcast on.
+          */
+         virtual std::vector<fc::oexception> handle_transactions( const std::vector<graphene::net::trx_message>& trx_msgs )
+         {
+            std::vector<fc::oexception> results( trx_msgs.size() );
+            for( size_t i = 0; i < trx_msgs.size(); ++i )
+            {
+               try
+               {
+                  handle_transaction( trx_msgs[i] );
+               }
+               catch( const fc::canceled_exception& )
+               {
+                  throw;
+               }
+               catch( const fc::exception& e )
+               {
+                  results[i] = e;
+               }
+            }
+            return results;
+         }
+
          /**
           *  @brief Called when a new message comes in from the network other than a
           *         block or a transaction.  Currently there are no other possible 
@@ -66,7 +66,7 @@ namespace graphene { namespace net
       virtual void on_message(peer_connection* originating_peer,
                               const message& received_message) = 0;
       virtual void on_connection_closed(peer_connection* originating_peer) = 0;
-      virtual message get_message_for_item(const item_id& item) = 0;
+      virtual message_ptr get_message_for_item(const item_id& item) = 0;
     };
 
     class peer_connection;
@@ -121,7 +121,7 @@ namespace graphene { namespace net
           enqueue_time(enqueue_time)
         {}
 
-        virtual message get_message(peer_connection_delegate* node) = 0;
+        virtual message_ptr get_message(peer_connection_delegate* node) = 0;
         /** returns roughly the number of bytes of memory the message is consuming while
          * it is sitting on the queue
          */
@@ -129,21 +129,22 @@ namespace graphene { namespace net
         virtual ~queued_message() = default;
       };
 
-      /* when you queue up a 'real_queued_message', a full copy of the message is
-       * stored on the heap until it is sent
+      /* when you queue up a 'real_queued_message', the message is held on the heap until
+       * it is sent.  The message may be shared with other peers' queues, so it is only
+       * copied if the send time has to be patched into it
        */
       struct real_queued_message : queued_message
       {
-        message        message_to_send;
+        message_ptr    message_to_send;
         size_t         message_send_time_field_offset;
 
-        real_queued_message(message message_to_send,
+        real_queued_message(message_ptr message_to_send,
                             size_t message_send_time_field_offset = (size_t)-1) :
           message_to_send(std::move(message_to_send)),
           message_send_time_field_offset(message_send_time_field_offset)
         {}
 
-        message get_message(peer_connection_delegate* node) override;
+        message_ptr get_message(peer_connection_delegate* node) override;
         size_t get_size_in_queue() override;
       };
 
@@ -159,7 +160,7 @@ namespace graphene { namespace net
           item_to_send(std::move(item_to_send))
         {}
 
-        message get_message(peer_connection_delegate* node) override;
+        message_ptr get_message(peer_connection_delegate* node) override;
         size_t get_size_in_queue() override;
       };
 
@@ -205,6 +206,7 @@ namespace graphene { namespace net
       fc::optional<fc::time_point_sec> fc_git_revision_unix_timestamp;
       fc::optional<std::string> platform;
       fc::optional<uint32_t> bitness;
+      bool             supports_compact_blocks = false; /// the peer can rebuild blocks sent as compact_block_message
 
       // for inbound connections, these fields record what the peer sent us in
       // its hello message.  For outbound, they record what we sent the peer
@@ -228,6 +230,10 @@ namespace graphene { namespace net
       item_hash_t last_block_delegate_has_seen; /// the hash of the last block  this peer has told us about that the peer knows
       fc::time_point_sec last_block_time_delegate_has_seen;
       bool inhibit_fetching_sync_blocks = false;
+      uint32_t sync_block_window = 0; /// how many sync blocks to request from this peer at a time, 0 until its throughput has been measured
+      double sync_blocks_per_second = 0; /// smoothed rate at which this peer has delivered sync blocks, 0 until measured
+      fc::time_point sync_batch_request_time; /// when the outstanding batch of sync blocks was requested from this peer
+      uint32_t sync_batch_size = 0; /// number of blocks in the outstanding batch
       /// @}
 
       /// non-synchronization state data
@@ -251,11 +257,20 @@ namespace graphene { namespace net
       timestamped_items_set_type inventory_advertised_to_peer;
 
       item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+
+      struct compact_block_awaiting_transactions
+      {
+        block_message         block; /// the block as far as we could rebuild it from our message cache
+        std::vector<uint32_t> missing_transaction_indices;
+      };
+      std::map<item_hash_t, compact_block_awaiting_transactions> compact_blocks_awaiting_transactions; /// compact blocks from this peer we've asked it for the missing transactions of, by block message hash
       /// @}
 
       // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
       // blockchain catch up
       fc::time_point transaction_fetching_inhibited_until;
+      fc::time_point transaction_rate_window_start; /// start of the one-second window transactions_received_in_rate_window counts in
+      uint32_t transactions_received_in_rate_window = 0; /// once this reaches GRAPHENE_NET_MAX_TRX_PER_SECOND, we stop fetching transactions from the peer until the window ends
 
       uint32_t last_known_fork_block_number = 0;
 
@@ -286,6 +301,7 @@ namespace graphene { namespace net
 
       void send_queueable_message(std::unique_ptr<queued_message>&& message_to_send);
       void send_message(const message& message_to_send, size_t message_send_time_field_offset = (size_t)-1);
+      void send_message(message_ptr message_to_send);
       void send_item(const item_id& item_to_send);
       void close_connection();
       void destroy_connection();
@@ -32,6 +32,7 @@
 #include <graphene/net/stcp_socket.hpp>
 #include <graphene/net/config.hpp>
 
+#include <algorithm>
 #include <atomic>
 
 #ifdef DEFAULT_LOGGER
@@ -268,15 +269,31 @@ namespace graphene { namespace net {
            elog("Trying to send a message larger than MAX_MESSAGE_SIZE. This probably won't work...");
         //pad the message we send to a multiple of 16 bytes
         size_t size_with_padding = 16 * ((size_of_message_and_header + 15) / 16);
-        std::unique_ptr<char[]> padded_message(new char[size_with_padding]);
 
-        memcpy(padded_message.get(), (char*)&message_to_send, sizeof(message_header));
-        memcpy(padded_message.get() + sizeof(message_header), message_to_send.data.data(), message_to_send.size );
-        char* paddingSpace = padded_message.get() + sizeof(message_header) + message_to_send.size;
-        size_t toClean = size_with_padding - size_of_message_and_header;
-        memset(paddingSpace, 0, toClean);
-
-        _sock.write(padded_message.get(), size_with_padding);
+        // The socket encrypts in 16-byte blocks, so rather than copying the whole message into a padded
+        // buffer, write it in three pieces: the header and the start of the body completing the first
+        // block, the block-aligned middle of the body straight from the (possibly shared) message, and
+        // the zero-padded tail.
+        const size_t block_size = 16;
+        const char* body = message_to_send.data.data();
+        size_t body_bytes_in_first_block = std::min<size_t>(block_size - sizeof(message_header), message_to_send.size);
+        size_t middle_length = (message_to_send.size - body_bytes_in_first_block) / block_size * block_size;
+        size_t tail_length = message_to_send.size - body_bytes_in_first_block - middle_length;
+
+        char first_block[block_size] = {};
+        memcpy(first_block, (char*)&message_to_send, sizeof(message_header));
+        memcpy(first_block + sizeof(message_header), body, body_bytes_in_first_block);
+        _sock.write(first_block, block_size);
+
+        if (middle_length)
+          _sock.write(body + body_bytes_in_first_block, middle_length);
+
+        if (tail_length)
+        {
+          char last_block[block_size] = {};
+          memcpy(last_block, body + body_bytes_in_first_block + middle_length, tail_length);
+          _sock.write(last_block, block_size);
+        }
         _sock.flush();
         _bytes_sent += size_with_padding;
         _last_message_sent_time = fc::time_point::now();
@@ -257,7 +257,7 @@ namespace graphene { namespace net {
       struct message_info
       {
         message_hash_type message_hash;
-        message           message_body;
+        message_ptr       message_body;
         uint32_t          block_clock_when_received;
 
         // for network performance stats
@@ -265,12 +265,12 @@ namespace graphene { namespace net {
         fc::uint160_t     message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is the transaction id, if it's a block, it's the block_id)
 
         message_info( const message_hash_type& message_hash,
-                      const message&           message_body,
+                      message_ptr              message_body,
                       uint32_t                 block_clock_when_received,
                       const message_propagation_data& propagation_data,
                       fc::uint160_t            message_contents_hash ) :
           message_hash( message_hash ),
-          message_body( message_body ),
+          message_body( std::move(message_body) ),
           block_clock_when_received( block_clock_when_received ),
           propagation_data( propagation_data ),
           message_contents_hash( message_contents_hash )
@@ -297,7 +297,8 @@ namespace graphene { namespace net {
       void block_accepted();
       void cache_message( const message& message_to_cache, const message_hash_type& hash_of_message_to_cache,
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
-      message get_message( const message_hash_type& hash_of_message_to_lookup );
+      message_ptr get_message( const message_hash_type& hash_of_message_to_lookup );
+      message_ptr find_message( const message_hash_type& hash_of_message_to_lookup ) const; /// like get_message, but returns null if it isn't cached
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
       size_t size() const { return _message_cache.size(); }
     };
@@ -315,14 +316,15 @@ namespace graphene { namespace net {
                                                      const message_propagation_data& propagation_data,
                                                      const fc::uint160_t& message_content_hash )
     {
+      // the cached copy is the only one; peers that request the message share it
       _message_cache.insert( message_info(hash_of_message_to_cache,
-                                         message_to_cache,
+                                         std::make_shared<message>(message_to_cache),
                                          block_clock,
                                          propagation_data,
                                          message_content_hash ) );
     }
 
-    message blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
+    message_ptr blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
     {
       message_cache_container::index<message_hash_index>::type::const_iterator iter =
          _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
@@ -331,6 +333,15 @@ namespace graphene { namespace net {
       FC_THROW_EXCEPTION(  fc::key_not_found_exception, "Requested message not in cache" );
     }
 
+    message_ptr blockchain_tied_message_cache::find_message( const message_hash_type& hash_of_message_to_lookup ) const
+    {
+      message_cache_container::index<message_hash_index>::type::const_iterator iter =
+         _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
+      if( iter != _message_cache.get<message_hash_index>().end() )
+        return iter->message_body;
+      return message_ptr();
+    }
+
     message_propagation_data blockchain_tied_message_cache::get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const
     {
       if( hash_of_message_contents_to_lookup != fc::uint160_t() )
@@ -410,7 +421,9 @@ namespace graphene { namespace net { namespace detail {
 #define NODE_DELEGATE_METHOD_NAMES (has_item) \
                                    (handle_message) \
                                    (handle_block) \
+                                   (prefetch_block) \
                                    (handle_transaction) \
+                                   (handle_transactions) \
                                    (get_block_ids) \
                                    (get_item) \
                                    (get_chain_id) \
@@ -507,7 +520,9 @@ namespace graphene { namespace net { namespace detail {
       bool has_item( const net::item_id& id ) override;
       void handle_message( const message& ) override;
       bool handle_block( const graphene::net::block_message& block_message, bool sync_mode, std::vector<fc::uint160_t>& contained_transaction_message_ids ) override;
+      void prefetch_block( const graphene::net::block_message& block_message ) override;
       void handle_transaction( const graphene::net::trx_message& transaction_message ) override;
+      std::vector<fc::oexception> handle_transactions( const std::vector<graphene::net::trx_message>& transaction_messages ) override;
       std::vector<item_hash_t> get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                              uint32_t& remaining_item_count,
                                              uint32_t limit = 2000) override;
@@ -571,9 +586,18 @@ namespace graphene { namespace net { namespace detail {
 
       typedef std::unordered_map<graphene::net::block_id_type, fc::time_point> active_sync_requests_map;
 
+      struct sync_block_id_index{};
+      /// reorder buffer for blocks that arrive out of order from different peers
+      typedef boost::multi_index_container
+        < graphene::net::block_message,
+            bmi::indexed_by< bmi::hashed_unique< bmi::tag<sync_block_id_index>,
+                                                 bmi::member<graphene::net::block_message, block_id_type, &graphene::net::block_message::block_id>,
+                                                 std::hash<block_id_type> > >
+        > received_sync_items_container;
+
       active_sync_requests_map              _active_sync_requests; /// list of sync blocks we've asked for from peers but have not yet received
       std::list<graphene::net::block_message> _new_received_sync_items; /// list of sync blocks we've just received but haven't yet tried to process
-      std::list<graphene::net::block_message> _received_sync_items; /// list of sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
+      received_sync_items_container         _received_sync_items; /// sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
       // @}
 
       fc::future<void> _process_backlog_of_sync_blocks_done;
@@ -597,6 +621,19 @@ namespace graphene { namespace net { namespace detail {
       peer_connection::timestamped_items_set_type _recently_failed_items; /// list of transactions we've recently pushed and had rejected by the delegate
       // @}
 
+      /// used by the task that hands received transactions to the delegate in batches
+      // @{
+      struct transaction_awaiting_ingress
+      {
+        message           transaction_message;
+        message_hash_type message_hash;
+        fc::time_point    receive_time;
+        node_id_t         originating_node_id;
+      };
+      std::map<peer_connection_ptr, std::deque<transaction_awaiting_ingress> > _transactions_awaiting_ingress; /// per peer, so a peer flooding us can't starve the others
+      fc::future<void> _process_transaction_ingress_done;
+      // @}
+
       /// used by the task that advertises inventory during normal operation
       // @{
       fc::promise<void>::ptr              _retrigger_advertise_inventory_loop_promise;
@@ -652,6 +689,8 @@ namespace graphene { namespace net { namespace detail {
       std::vector<uint32_t> _hard_fork_block_numbers; /// list of all block numbers where there are hard forks
 
       blockchain_tied_message_cache _message_cache; /// cache message we have received and might be required to provide to other peers via inventory requests
+      item_hash_t _most_recent_compact_block_hash; /// the block we last built a compact_block_message for, usually requested by many peers in a row
+      message_ptr _most_recent_compact_block;
 
       fc::rate_limiting_group _rate_limiter;
 
@@ -717,6 +756,7 @@ namespace graphene { namespace net { namespace detail {
       bool have_already_received_sync_item( const item_hash_t& item_hash );
       void request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request );
       void request_sync_items_from_peer( const peer_connection_ptr& peer, const std::vector<item_hash_t>& items_to_request );
+      void update_sync_block_window( peer_connection* peer );
       void fetch_sync_items_loop();
       void trigger_fetch_sync_items_loop();
 
@@ -805,6 +845,21 @@ namespace graphene { namespace net { namespace detail {
       void on_get_current_connections_reply_message(peer_connection* originating_peer,
                                                     const get_current_connections_reply_message& get_current_connections_reply_message_received);
 
+      message_ptr get_compact_block_message(const item_hash_t& item_hash, const message_ptr& block_message_to_compact);
+
+      void on_compact_block_message(peer_connection* originating_peer,
+                                    const compact_block_message& compact_block_message_received);
+
+      void on_fetch_block_transactions_message(peer_connection* originating_peer,
+                                               const fetch_block_transactions_message& fetch_block_transactions_message_received);
+
+      void on_block_transactions_message(peer_connection* originating_peer,
+                                         const block_transactions_message& block_transactions_message_received);
+
+      void process_rebuilt_compact_block(peer_connection* originating_peer,
+                                         const graphene::net::block_message& rebuilt_block,
+                                         const item_hash_t& item_hash);
+
       void on_connection_closed(peer_connection* originating_peer) override;
 
       void send_sync_block_to_node_delegate(const graphene::net::block_message& block_message_to_send);
@@ -813,8 +868,11 @@ namespace graphene { namespace net { namespace detail {
       void process_block_during_sync(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
       void process_block_during_normal_operation(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
       void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
+      void process_block_message(peer_connection* originating_peer, const graphene::net::block_message& block_message_to_process, const message_hash_type& message_hash);
 
       void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
+      void process_transaction_ingress();
+      void trigger_process_transaction_ingress();
 
       void start_synchronizing();
       void start_synchronizing_with_peer(const peer_connection_ptr& peer);
@@ -883,7 +941,7 @@ namespace graphene { namespace net { namespace detail {
       void                       set_total_bandwidth_limit( uint32_t upload_bytes_per_second, uint32_t download_bytes_per_second );
       void                       disable_peer_advertising();
       fc::variant_object         get_call_statistics() const;
-      message                    get_message_for_item(const item_id& item) override;
+      message_ptr                get_message_for_item(const item_id& item) override;
 
       fc::variant_object         network_get_info() const;
       fc::variant_object         network_get_usage_stats() const;
@@ -1134,8 +1192,7 @@ namespace graphene { namespace net { namespace detail {
     bool node_impl::have_already_received_sync_item( const item_hash_t& item_hash )
     {
       VERIFY_CORRECT_THREAD();
-      return std::find_if(_received_sync_items.begin(), _received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _received_sync_items.end() ||
+      return _received_sync_items.get<sync_block_id_index>().count(item_hash) != 0 ||
              std::find_if(_new_received_sync_items.begin(), _new_received_sync_items.end(),
                           [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _new_received_sync_items.end();                          ;
     }
@@ -1162,9 +1219,30 @@ namespace graphene { namespace net { namespace detail {
         item_id item_id_to_request( graphene::net::block_message_type, item_to_request );
         peer->sync_items_requested_from_peer.insert( peer_connection::item_to_time_map_type::value_type(item_id_to_request, fc::time_point::now() ) );
       }
+      peer->sync_batch_request_time = fc::time_point::now();
+      peer->sync_batch_size = (uint32_t)items_to_request.size();
       peer->send_message(fetch_items_message(graphene::net::block_message_type, items_to_request));
     }
 
+    void node_impl::update_sync_block_window( peer_connection* peer )
+    {
+      VERIFY_CORRECT_THREAD();
+      if (!peer->sync_batch_size)
+        return;
+      int64_t elapsed_microseconds = std::max<int64_t>((fc::time_point::now() - peer->sync_batch_request_time).count(), 1);
+      double batch_blocks_per_second = peer->sync_batch_size * 1000000.0 / elapsed_microseconds;
+      peer->sync_blocks_per_second = peer->sync_blocks_per_second > 0 ?
+                                     (peer->sync_blocks_per_second + batch_blocks_per_second) / 2 :
+                                     batch_blocks_per_second;
+      peer->sync_batch_size = 0;
+
+      double window = peer->sync_blocks_per_second * GRAPHENE_NET_SYNC_BATCH_TARGET_DURATION_SEC;
+      peer->sync_block_window = (uint32_t)std::max<double>(GRAPHENE_NET_MIN_BLOCKS_PER_PEER_DURING_SYNCING,
+                                                           std::min<double>(window, _maximum_blocks_per_peer_during_syncing));
+      dlog("peer ${endpoint} delivered sync blocks at ${rate} blocks/sec, will request ${window} at a time",
+           ("endpoint", peer->get_remote_endpoint())("rate", peer->sync_blocks_per_second)("window", peer->sync_block_window));
+    }
+
     void node_impl::fetch_sync_items_loop()
     {
       VERIFY_CORRECT_THREAD();
@@ -1181,32 +1259,38 @@ namespace graphene { namespace net { namespace detail {
             ASSERT_TASK_NOT_PREEMPTED();
             std::set<item_hash_t> sync_items_to_request;
 
-            // for each idle peer that we're syncing with
+            // for each idle peer that we're syncing with, fastest first, so the earliest blocks we still
+            // need (the ones holding up applying everything behind them) go to the fastest peers
             fc::scoped_lock<fc::mutex> lock(_active_connections.get_mutex());
+            std::vector<peer_connection_ptr> idle_sync_peers;
             for( const peer_connection_ptr& peer : _active_connections )
+              if( peer->we_need_sync_items_from_peer && peer->idle() && !peer->inhibit_fetching_sync_blocks )
+                idle_sync_peers.push_back( peer );
+            std::stable_sort( idle_sync_peers.begin(), idle_sync_peers.end(),
+                              []( const peer_connection_ptr& a, const peer_connection_ptr& b ) {
+                                return a->sync_blocks_per_second > b->sync_blocks_per_second;
+                              } );
+
+            for( const peer_connection_ptr& peer : idle_sync_peers )
             {
-              if( peer->we_need_sync_items_from_peer &&
-                  sync_item_requests_to_send.find(peer) == sync_item_requests_to_send.end() && // if we've already scheduled a request for this peer, don't consider scheduling another
-                  peer->idle() )
+              uint32_t blocks_to_request = _maximum_blocks_per_peer_during_syncing;
+              if( peer->sync_block_window )
+                blocks_to_request = std::min<uint32_t>( peer->sync_block_window, blocks_to_request );
+
+              // loop through the items it has that we don't yet have on our blockchain
+              for( unsigned i = 0; i < peer->ids_of_items_to_get.size(); ++i )
               {
-                if (!peer->inhibit_fetching_sync_blocks)
+                item_hash_t item_to_potentially_request = peer->ids_of_items_to_get[i];
+                // if we don't already have this item in our temporary storage and we haven't requested from another syncing peer
+                if( !have_already_received_sync_item(item_to_potentially_request) && // already got it, but for some reson it's still in our list of items to fetch
+                    sync_items_to_request.find(item_to_potentially_request) == sync_items_to_request.end() &&  // we have already decided to request it from another peer during this iteration
+                    _active_sync_requests.find(item_to_potentially_request) == _active_sync_requests.end() ) // we've requested it in a previous iteration and we're still waiting for it to arrive
                 {
-                  // loop through the items it has that we don't yet have on our blockchain
-                  for( unsigned i = 0; i < peer->ids_of_items_to_get.size(); ++i )
-                  {
-                    item_hash_t item_to_potentially_request = peer->ids_of_items_to_get[i];
-                    // if we don't already have this item in our temporary storage and we haven't requested from another syncing peer
-                    if( !have_already_received_sync_item(item_to_potentially_request) && // already got it, but for some reson it's still in our list of items to fetch
-                        sync_items_to_request.find(item_to_potentially_request) == sync_items_to_request.end() &&  // we have already decided to request it from another peer during this iteration
-                        _active_sync_requests.find(item_to_potentially_request) == _active_sync_requests.end() ) // we've requested it in a previous iteration and we're still waiting for it to arrive
-                    {
-                      // then schedule a request from this peer
-                      sync_item_requests_to_send[peer].push_back(item_to_potentially_request);
-                      sync_items_to_request.insert( item_to_potentially_request );
-                      if (sync_item_requests_to_send[peer].size() >= _maximum_blocks_per_peer_during_syncing)
-                        break;
-                    }
-                  }
+                  // then schedule a request from this peer
+                  sync_item_requests_to_send[peer].push_back(item_to_potentially_request);
+                  sync_items_to_request.insert( item_to_potentially_request );
+                  if (sync_item_requests_to_send[peer].size() >= blocks_to_request)
+                    break;
                 }
               }
             }
@@ -2019,6 +2103,15 @@ namespace graphene { namespace net { namespace detail {
       case core_message_type_enum::get_current_connections_reply_message_type:
         on_get_current_connections_reply_message(originating_peer, received_message.as<get_current_connections_reply_message>());
         break;
+      case core_message_type_enum::compact_block_message_type:
+        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+        break;
+      case core_message_type_enum::fetch_block_transactions_message_type:
+        on_fetch_block_transactions_message(originating_peer, received_message.as<fetch_block_transactions_message>());
+        break;
+      case core_message_type_enum::block_transactions_message_type:
+        on_block_transactions_message(originating_peer, received_message.as<block_transactions_message>());
+        break;
 
       default:
         // ignore any message in between core_message_type_first and _last that we don't handle above
@@ -2051,6 +2144,7 @@ namespace graphene { namespace net { namespace detail {
       user_data["platform"] = "other";
 #endif
       user_data["bitness"] = sizeof(void*) * 8;
+      user_data["compact_blocks"] = true;
 
       user_data["node_id"] = fc::variant( _node_id, 1 );
 
@@ -2083,6 +2177,8 @@ namespace graphene { namespace net { namespace detail {
         originating_peer->bitness = user_data["bitness"].as<uint32_t>(1);
       if (user_data.contains("node_id"))
         originating_peer->node_id = user_data["node_id"].as<node_id_t>(1);
+      if (user_data.contains("compact_blocks"))
+        originating_peer->supports_compact_blocks = user_data["compact_blocks"].as_bool();
       if (user_data.contains("last_known_fork_block_number"))
         originating_peer->last_known_fork_block_number = user_data["last_known_fork_block_number"].as<uint32_t>(1);
       if (user_data.contains("last_known_hardfork_time")){
@@ -2975,7 +3071,7 @@ namespace graphene { namespace net { namespace detail {
       }
     }
 
-    message node_impl::get_message_for_item(const item_id& item)
+    message_ptr node_impl::get_message_for_item(const item_id& item)
     {
       try
       {
@@ -2985,11 +3081,11 @@ namespace graphene { namespace net { namespace detail {
       {}
       try
       {
-        return _delegate->get_item(item);
+        return std::make_shared<message>(_delegate->get_item(item));
       }
       catch (fc::key_not_found_exception&)
       {}
-      return item_not_available_message(item);
+      return std::make_shared<message>(item_not_available_message(item));
     }
 
     void node_impl::on_fetch_items_message(peer_connection* originating_peer, const fetch_items_message& fetch_items_message_received)
@@ -3000,20 +3096,29 @@ namespace graphene { namespace net { namespace detail {
            ("type", fetch_items_message_received.item_type)
            ("endpoint", originating_peer->get_remote_endpoint()));
 
-      fc::optional<message> last_block_message_sent;
+      message_ptr last_block_message_sent;
 
-      std::list<message> reply_messages;
+      std::list<message_ptr> reply_messages;
       for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
       {
         try
         {
-          message requested_message = _message_cache.get_message(item_hash);
+          message_ptr requested_message = _message_cache.get_message(item_hash);
           dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                ("endpoint", originating_peer->get_remote_endpoint())
-               ("id", requested_message.id()));
-          reply_messages.push_back(requested_message);
+               ("id", requested_message->id()));
           if (fetch_items_message_received.item_type == block_message_type)
+          {
             last_block_message_sent = requested_message;
+            // a block we've just relayed; the peer has most likely seen its transactions already.
+            // peers syncing from us won't have, so they still get the full block
+            if (originating_peer->supports_compact_blocks && !originating_peer->peer_needs_sync_items_from_us)
+            {
+              reply_messages.push_back(get_compact_block_message(item_hash, requested_message));
+              continue;
+            }
+          }
+          reply_messages.push_back(requested_message);
           continue;
         }
         catch (fc::key_not_found_exception&)
@@ -3024,10 +3129,10 @@ namespace graphene { namespace net { namespace detail {
         item_id item_to_fetch(fetch_items_message_received.item_type, item_hash);
         try
         {
-          message requested_message = _delegate->get_item(item_to_fetch);
+          message_ptr requested_message = std::make_shared<message>(_delegate->get_item(item_to_fetch));
           dlog("received item request from peer ${endpoint}, returning the item from delegate with id ${id} size ${size}",
-               ("id", requested_message.id())
-               ("size", requested_message.size)
+               ("id", requested_message->id())
+               ("size", requested_message->size)
                ("endpoint", originating_peer->get_remote_endpoint()));
           reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
@@ -3036,7 +3141,7 @@ namespace graphene { namespace net { namespace detail {
         }
         catch (fc::key_not_found_exception&)
         {
-          reply_messages.push_back(item_not_available_message(item_to_fetch));
+          reply_messages.push_back(std::make_shared<message>(item_not_available_message(item_to_fetch)));
           dlog("received item request from peer ${endpoint} but we don't have it",
                ("endpoint", originating_peer->get_remote_endpoint()));
         }
@@ -3050,19 +3155,176 @@ namespace graphene { namespace net { namespace detail {
         originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
       }
 
-      for (const message& reply : reply_messages)
+      for (const message_ptr& reply : reply_messages)
       {
-        if (reply.msg_type == block_message_type)
-          originating_peer->send_item(item_id(block_message_type, reply.as<graphene::net::block_message>().block_id));
+        if (reply->msg_type == block_message_type)
+          originating_peer->send_item(item_id(block_message_type, reply->as<graphene::net::block_message>().block_id));
         else
           originating_peer->send_message(reply);
       }
     }
 
+    message_ptr node_impl::get_compact_block_message(const item_hash_t& item_hash, const message_ptr& block_message_to_compact)
+    {
+      VERIFY_CORRECT_THREAD();
+      if (!_most_recent_compact_block || _most_recent_compact_block_hash != item_hash)
+      {
+        graphene::net::block_message block = block_message_to_compact->as<graphene::net::block_message>();
+        _most_recent_compact_block = std::make_shared<message>(compact_block_message(item_hash, block.block));
+        _most_recent_compact_block_hash = item_hash;
+      }
+      return _most_recent_compact_block;
+    }
+
+    void node_impl::on_compact_block_message(peer_connection* originating_peer,
+                                             const compact_block_message& compact_block_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& item_hash = compact_block_message_received.item_hash;
+      // blocks are never compacted for peers that sync from the sender, so only regular requests qualify
+      if (originating_peer->items_requested_from_peer.find(item_id(block_message_type, item_hash)) == originating_peer->items_requested_from_peer.end())
+      {
+        wlog("received a compact block ${item_hash} I didn't ask for from peer ${endpoint}, disconnecting from peer",
+             ("endpoint", originating_peer->get_remote_endpoint())
+             ("item_hash", item_hash));
+        fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a block that I didn't ask for, item_hash: ${item_hash}",
+                                                    ("item_hash", item_hash)));
+        disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
+        return;
+      }
+
+      // rebuild the block from the transactions we've already received and relayed
+      graphene::chain::signed_block block;
+      static_cast<graphene::chain::signed_block_header&>(block) = compact_block_message_received.header;
+      block.transactions.resize(compact_block_message_received.transactions.size());
+      std::vector<uint32_t> missing_transaction_indices;
+      for (uint32_t i = 0; i < compact_block_message_received.transactions.size(); ++i)
+      {
+        const compact_transaction& transaction = compact_block_message_received.transactions[i];
+        message_ptr transaction_message = _message_cache.find_message(transaction.message_id);
+        if (transaction_message && transaction_message->msg_type == trx_message_type)
+        {
+          static_cast<signed_transaction&>(block.transactions[i]) = transaction_message->as<trx_message>().trx;
+          block.transactions[i].operation_results = transaction.operation_results;
+        }
+        else
+          missing_transaction_indices.push_back(i);
+      }
+
+      if (missing_transaction_indices.empty())
+      {
+        dlog("rebuilt compact block ${item_hash} from peer ${endpoint} with all ${count} transactions from my message cache",
+             ("item_hash", item_hash)("endpoint", originating_peer->get_remote_endpoint())("count", block.transactions.size()));
+        process_rebuilt_compact_block(originating_peer, graphene::net::block_message(block), item_hash);
+        return;
+      }
+
+      dlog("missing ${missing} of ${count} transactions in compact block ${item_hash} from peer ${endpoint}, requesting them",
+           ("missing", missing_transaction_indices.size())("count", block.transactions.size())
+           ("item_hash", item_hash)("endpoint", originating_peer->get_remote_endpoint()));
+      peer_connection::compact_block_awaiting_transactions& awaiting = originating_peer->compact_blocks_awaiting_transactions[item_hash];
+      awaiting.block = graphene::net::block_message(block);
+      awaiting.missing_transaction_indices = missing_transaction_indices;
+      originating_peer->send_message(fetch_block_transactions_message(item_hash, missing_transaction_indices));
+    }
+
+    void node_impl::on_fetch_block_transactions_message(peer_connection* originating_peer,
+                                                        const fetch_block_transactions_message& fetch_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& item_hash = fetch_block_transactions_message_received.item_hash;
+      message_ptr requested_message = _message_cache.find_message(item_hash);
+      if (requested_message && requested_message->msg_type == block_message_type)
+      {
+        graphene::net::block_message block = requested_message->as<graphene::net::block_message>();
+        std::vector<signed_transaction> transactions;
+        transactions.reserve(fetch_block_transactions_message_received.transaction_indices.size());
+        for (uint32_t transaction_index : fetch_block_transactions_message_received.transaction_indices)
+        {
+          if (transaction_index >= block.block.transactions.size())
+          {
+            transactions.clear();
+            break;
+          }
+          transactions.push_back(block.block.transactions[transaction_index]);
+        }
+        if (transactions.size() == fetch_block_transactions_message_received.transaction_indices.size())
+        {
+          originating_peer->send_message(block_transactions_message(item_hash, std::move(transactions)));
+          return;
+        }
+      }
+
+      dlog("peer ${endpoint} asked for transactions of block ${item_hash} that we can't provide",
+           ("endpoint", originating_peer->get_remote_endpoint())("item_hash", item_hash));
+      originating_peer->send_message(item_not_available_message(item_id(block_message_type, item_hash)));
+    }
+
+    void node_impl::on_block_transactions_message(peer_connection* originating_peer,
+                                                  const block_transactions_message& block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& item_hash = block_transactions_message_received.item_hash;
+      auto awaiting_iter = originating_peer->compact_blocks_awaiting_transactions.find(item_hash);
+      if (awaiting_iter == originating_peer->compact_blocks_awaiting_transactions.end() ||
+          awaiting_iter->second.missing_transaction_indices.size() != block_transactions_message_received.transactions.size())
+      {
+        wlog("received transactions for block ${item_hash} I didn't ask for from peer ${endpoint}, disconnecting from peer",
+             ("endpoint", originating_peer->get_remote_endpoint())
+             ("item_hash", item_hash));
+        fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me block transactions that I didn't ask for, item_hash: ${item_hash}",
+                                                    ("item_hash", item_hash)));
+        disconnect_from_peer(originating_peer, "You sent me block transactions that I didn't ask for", true, detailed_error);
+        return;
+      }
+
+      graphene::net::block_message block_message_to_process = std::move(awaiting_iter->second.block);
+      const std::vector<uint32_t>& missing_transaction_indices = awaiting_iter->second.missing_transaction_indices;
+      for (size_t i = 0; i < missing_transaction_indices.size(); ++i)
+        static_cast<signed_transaction&>(block_message_to_process.block.transactions[missing_transaction_indices[i]]) =
+            block_transactions_message_received.transactions[i];
+      originating_peer->compact_blocks_awaiting_transactions.erase(awaiting_iter);
+
+      process_rebuilt_compact_block(originating_peer, block_message_to_process, item_hash);
+    }
+
+    void node_impl::process_rebuilt_compact_block(peer_connection* originating_peer,
+                                                  const graphene::net::block_message& rebuilt_block,
+                                                  const item_hash_t& item_hash)
+    {
+      VERIFY_CORRECT_THREAD();
+      // the block was put together from the peer's header and transactions, check it is the block we asked for
+      const item_hash_t rebuilt_hash = message(rebuilt_block).id();
+      if (rebuilt_hash != item_hash)
+      {
+        wlog("compact block ${item_hash} from peer ${endpoint} rebuilt to a different block ${rebuilt_hash}, disconnecting from peer",
+             ("item_hash", item_hash)("rebuilt_hash", rebuilt_hash)("endpoint", originating_peer->get_remote_endpoint()));
+
+        // fetch the block from another peer instead
+        const item_id requested_item(block_message_type, item_hash);
+        originating_peer->items_requested_from_peer.erase(requested_item);
+        originating_peer->inventory_peer_advertised_to_us.erase(requested_item);
+        if (is_item_in_any_peers_inventory(requested_item))
+        {
+          _items_to_fetch.insert(prioritized_item_id(requested_item, _items_to_fetch_sequence_counter++));
+          trigger_fetch_items_loop();
+        }
+
+        fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a compact block that doesn't match its id, item_hash: ${item_hash}",
+                                                    ("item_hash", item_hash)));
+        disconnect_from_peer(originating_peer, "You sent me a compact block that doesn't match its id", true, detailed_error);
+        return;
+      }
+
+      process_block_message(originating_peer, rebuilt_block, item_hash);
+    }
+
     void node_impl::on_item_not_available_message( peer_connection* originating_peer, const item_not_available_message& item_not_available_message_received )
     {
       VERIFY_CORRECT_THREAD();
       const item_id& requested_item = item_not_available_message_received.requested_item;
+      if (requested_item.item_type == block_message_type)
+        originating_peer->compact_blocks_awaiting_transactions.erase(requested_item.item_hash);
       auto regular_item_iter = originating_peer->items_requested_from_peer.find(requested_item);
       if (regular_item_iter != originating_peer->items_requested_from_peer.end())
       {
@@ -3522,88 +3784,95 @@ namespace graphene { namespace net { namespace detail {
 
       do
       {
-        std::copy(std::make_move_iterator(_new_received_sync_items.begin()),
-                  std::make_move_iterator(_new_received_sync_items.end()),
-                  std::front_inserter(_received_sync_items));
+        for (graphene::net::block_message& new_received_sync_item : _new_received_sync_items)
+          _received_sync_items.insert(std::move(new_received_sync_item));
         _new_received_sync_items.clear();
         dlog("currently ${count} sync items to consider", ("count", _received_sync_items.size()));
 
         block_processed_this_iteration = false;
-        for (auto received_block_iter = _received_sync_items.begin();
-             received_block_iter != _received_sync_items.end();
-             ++received_block_iter)
+        auto& received_blocks_by_id = _received_sync_items.get<sync_block_id_index>();
+        auto received_block_iter = received_blocks_by_id.end();
         {
-
-          // find out if this block is the next block on the active chain or one of the forks
-          bool potential_first_block = false;
+          // the next block on the active chain or one of the forks is at the front of some syncing
+          // peer's list, so look those up in the reorder buffer instead of scanning everything we hold
+          fc::scoped_lock<fc::mutex> lock(_active_connections.get_mutex());
+          for (const peer_connection_ptr& peer : _active_connections)
           {
-            fc::scoped_lock<fc::mutex> lock(_active_connections.get_mutex());
+            ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+            if (peer->ids_of_items_to_get.empty())
+              continue;
+            auto iter = received_blocks_by_id.find(peer->ids_of_items_to_get.front());
+            if (iter != received_blocks_by_id.end() &&
+                (received_block_iter == received_blocks_by_id.end() ||
+                 block_header::num_from_id(iter->block_id) < block_header::num_from_id(received_block_iter->block_id)))
+              received_block_iter = iter;
+          }
+
+          if (received_block_iter != received_blocks_by_id.end())
             for (const peer_connection_ptr& peer : _active_connections)
             {
               ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
               if (!peer->ids_of_items_to_get.empty() &&
                   peer->ids_of_items_to_get.front() == received_block_iter->block_id)
               {
-                potential_first_block = true;
                 peer->ids_of_items_to_get.pop_front();
                 peer->ids_of_items_being_processed.insert(received_block_iter->block_id);
               }
             }
-          }
+        }
 
-          // if it is, process it, remove it from all sync peers lists
-          if (potential_first_block)
+        // if we found one, process it; it has already been removed from all sync peers lists
+        if (received_block_iter != received_blocks_by_id.end())
+        {
+          // we can get into an interesting situation near the end of synchronization.  We can be in
+          // sync with one peer who is sending us the last block on the chain via a regular inventory
+          // message, while at the same time still be synchronizing with a peer who is sending us the
+          // block through the sync mechanism.  Further, we must request both blocks because
+          // we don't know they're the same (for the peer in normal operation, it has only told us the
+          // message id, for the peer in the sync case we only known the block_id).
+          if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
+                        received_block_iter->block_id) == _most_recent_blocks_accepted.end())
           {
-            // we can get into an interesting situation near the end of synchronization.  We can be in
-            // sync with one peer who is sending us the last block on the chain via a regular inventory
-            // message, while at the same time still be synchronizing with a peer who is sending us the
-            // block through the sync mechanism.  Further, we must request both blocks because
-            // we don't know they're the same (for the peer in normal operation, it has only told us the
-            // message id, for the peer in the sync case we only known the block_id).
-            if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
-                          received_block_iter->block_id) == _most_recent_blocks_accepted.end())
-            {
-              graphene::net::block_message block_message_to_process = *received_block_iter;
-              _received_sync_items.erase(received_block_iter);
-              _handle_message_calls_in_progress.emplace_back(fc::async([this, block_message_to_process](){
-                send_sync_block_to_node_delegate(block_message_to_process);
-              }, "send_sync_block_to_node_delegate"));
-              ++blocks_processed;
-              block_processed_this_iteration = true;
-            }
-            else
+            graphene::net::block_message block_message_to_process = *received_block_iter;
+            received_blocks_by_id.erase(received_block_iter);
+            _handle_message_calls_in_progress.emplace_back(fc::async([this, block_message_to_process](){
+              send_sync_block_to_node_delegate(block_message_to_process);
+            }, "send_sync_block_to_node_delegate"));
+            ++blocks_processed;
+            block_processed_this_iteration = true;
+          }
+          else
+          {
+            dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
+            std::vector< peer_connection_ptr > peers_needing_next_batch;
+            fc::scoped_lock<fc::mutex> lock(_active_connections.get_mutex());
+            for (const peer_connection_ptr& peer : _active_connections)
             {
-              dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
-              std::vector< peer_connection_ptr > peers_needing_next_batch;
-              fc::scoped_lock<fc::mutex> lock(_active_connections.get_mutex());
-              for (const peer_connection_ptr& peer : _active_connections)
+              auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_iter->block_id);
+              if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
               {
-                auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_iter->block_id);
-                if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
+                peer->ids_of_items_being_processed.erase(items_being_processed_iter);
+                dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
+                     ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
+
+                // if we just processed the last item in our list from this peer, we will want to
+                // send another request to find out if we are now in sync (this is normally handled in
+                // send_sync_block_to_node_delegate)
+                if (peer->ids_of_items_to_get.empty() &&
+                    peer->number_of_unfetched_item_ids == 0 &&
+                    peer->ids_of_items_being_processed.empty())
                 {
-                  peer->ids_of_items_being_processed.erase(items_being_processed_iter);
-                  dlog("Removed item from ${endpoint}'s list of items being processed, still processing ${len} blocks",
-                       ("endpoint", peer->get_remote_endpoint())("len", peer->ids_of_items_being_processed.size()));
-
-                  // if we just processed the last item in our list from this peer, we will want to
-                  // send another request to find out if we are now in sync (this is normally handled in
-                  // send_sync_block_to_node_delegate)
-                  if (peer->ids_of_items_to_get.empty() &&
-                      peer->number_of_unfetched_item_ids == 0 &&
-                      peer->ids_of_items_being_processed.empty())
-                  {
-                    dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
-                    peers_needing_next_batch.push_back( peer );
-                  }
+                  dlog("We received last item in our list for peer ${endpoint}, setup to do a sync check", ("endpoint", peer->get_remote_endpoint()));
+                  peers_needing_next_batch.push_back( peer );
                 }
               }
-              for( const peer_connection_ptr& peer : peers_needing_next_batch )
-                fetch_next_batch_of_item_ids_from_peer(peer.get());
             }
-
-            break; // start iterating _received_sync_items from the beginning
-          } // end if potential_first_block
-        } // end for each block in _received_sync_items
+            received_blocks_by_id.erase(received_block_iter);
+            block_processed_this_iteration = true;
+            for( const peer_connection_ptr& peer : peers_needing_next_batch )
+              fetch_next_batch_of_item_ids_from_peer(peer.get());
+          }
+        } // end if a next block was found in _received_sync_items
 
         if (_handle_message_calls_in_progress.size() >= _maximum_number_of_blocks_to_handle_at_one_time)
         {
@@ -3636,6 +3905,20 @@ namespace graphene { namespace net { namespace detail {
       VERIFY_CORRECT_THREAD();
       dlog( "received a sync block from peer ${endpoint}", ("endpoint", originating_peer->get_remote_endpoint() ) );
 
+      // let the client start preprocessing the block while earlier blocks are being applied
+      try
+      {
+        _delegate->prefetch_block( block_message_to_process );
+      }
+      catch (const fc::canceled_exception&)
+      {
+        throw;
+      }
+      catch (const fc::exception& e)
+      {
+        wlog( "Failed to prefetch sync block ${num}: ${e}", ("num", block_message_to_process.block.block_num())("e", e) );
+      }
+
       // add it to the front of _received_sync_items, then process _received_sync_items to try to
       // pass as many messages as possible to the client.
       _new_received_sync_items.push_front( block_message_to_process );
@@ -3830,13 +4113,19 @@ namespace graphene { namespace net { namespace detail {
     void node_impl::process_block_message(peer_connection* originating_peer,
                                           const message& message_to_process,
                                           const message_hash_type& message_hash)
+    {
+      process_block_message(originating_peer, message_to_process.as<graphene::net::block_message>(), message_hash);
+    }
+
+    void node_impl::process_block_message(peer_connection* originating_peer,
+                                          const graphene::net::block_message& block_message_to_process,
+                                          const message_hash_type& message_hash)
     {
       VERIFY_CORRECT_THREAD();
       // find out whether we requested this item while we were synchronizing or during normal operation
       // (it's possible that we request an item during normal operation and then get kicked into sync
       // mode before we receive and process the item.  In that case, we should process the item as a normal
       // item to avoid confusing the sync code)
-      graphene::net::block_message block_message_to_process(message_to_process.as<graphene::net::block_message>());
       auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
@@ -3854,6 +4143,8 @@ namespace graphene { namespace net { namespace detail {
         if (sync_item_iter != originating_peer->sync_items_requested_from_peer.end())
         {
           originating_peer->sync_items_requested_from_peer.erase(sync_item_iter);
+          if (originating_peer->sync_items_requested_from_peer.empty())
+            update_sync_block_window(originating_peer);
           // if exceptions are throw here after removing the sync item from the list (above),
           // it could leave our sync in a stalled state.  Wrap a try/catch around the rest
           // of the function so we can log if this ever happens.
@@ -4199,6 +4490,34 @@ namespace graphene { namespace net { namespace detail {
       else
       {
         originating_peer->items_requested_from_peer.erase( iter );
+
+        if (message_to_process.msg_type == trx_message_type)
+        {
+          // transactions are handed to the delegate in batches, which are taken fairly from all peers
+          // and let the delegate check their signatures in parallel
+          fc::time_point window_end = originating_peer->transaction_rate_window_start + fc::seconds(1);
+          if (message_receive_time >= window_end)
+          {
+            originating_peer->transaction_rate_window_start = message_receive_time;
+            originating_peer->transactions_received_in_rate_window = 0;
+            window_end = message_receive_time + fc::seconds(1);
+          }
+          if (++originating_peer->transactions_received_in_rate_window >= GRAPHENE_NET_MAX_TRX_PER_SECOND)
+          {
+            dlog("peer ${endpoint} sent us ${count} transactions within a second, not fetching more from it until ${until}",
+                 ("endpoint", originating_peer->get_remote_endpoint())
+                 ("count", originating_peer->transactions_received_in_rate_window)("until", window_end));
+            originating_peer->transaction_fetching_inhibited_until = window_end;
+          }
+
+          _transactions_awaiting_ingress[originating_peer->shared_from_this()].push_back(
+              transaction_awaiting_ingress{message_to_process, message_hash, message_receive_time, originating_peer->node_id});
+          trigger_process_transaction_ingress();
+          if (originating_peer->idle())
+            trigger_fetch_items_loop();
+          return;
+        }
+
         if (originating_peer->idle())
           trigger_fetch_items_loop();
 
@@ -4206,14 +4525,7 @@ namespace graphene { namespace net { namespace detail {
         fc::time_point message_validated_time;
         try
         {
-          if (message_to_process.msg_type == trx_message_type)
-          {
-            trx_message transaction_message_to_process = message_to_process.as<trx_message>();
-            dlog("passing message containing transaction ${trx} to client", ("trx", transaction_message_to_process.trx.id()));
-            _delegate->handle_transaction(transaction_message_to_process);
-          }
-          else
-            _delegate->handle_message( message_to_process );
+          _delegate->handle_message( message_to_process );
           message_validated_time = fc::time_point::now();
         }
         catch ( const fc::canceled_exception& )
@@ -4234,6 +4546,88 @@ namespace graphene { namespace net { namespace detail {
       }
     }
 
+    void node_impl::process_transaction_ingress()
+    {
+      VERIFY_CORRECT_THREAD();
+      while (!_transactions_awaiting_ingress.empty() && !_node_is_shutting_down)
+      {
+        // take up to GRAPHENE_NET_MAX_TRX_PER_PEER_PER_BATCH transactions from each peer, in the order each peer sent them
+        std::vector<transaction_awaiting_ingress> batch;
+        for (auto peer_iter = _transactions_awaiting_ingress.begin(); peer_iter != _transactions_awaiting_ingress.end();)
+        {
+          std::deque<transaction_awaiting_ingress>& peer_transactions = peer_iter->second;
+          for (unsigned i = 0; i < GRAPHENE_NET_MAX_TRX_PER_PEER_PER_BATCH && !peer_transactions.empty(); ++i)
+          {
+            batch.push_back(std::move(peer_transactions.front()));
+            peer_transactions.pop_front();
+          }
+          if (peer_transactions.empty())
+            peer_iter = _transactions_awaiting_ingress.erase(peer_iter);
+          else
+            ++peer_iter;
+        }
+
+        std::vector<trx_message> transaction_messages;
+        std::vector<fc::oexception> results(batch.size());
+        std::vector<size_t> batch_indices; // position in batch of each entry in transaction_messages
+        transaction_messages.reserve(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+          try
+          {
+            transaction_messages.push_back(batch[i].transaction_message.as<trx_message>());
+            batch_indices.push_back(i);
+          }
+          catch (const fc::exception& e)
+          {
+            results[i] = e;
+          }
+        }
+        dlog("passing a batch of ${count} transactions to client", ("count", transaction_messages.size()));
+
+        try
+        {
+          std::vector<fc::oexception> delegate_results = _delegate->handle_transactions(transaction_messages);
+          for (size_t i = 0; i < batch_indices.size() && i < delegate_results.size(); ++i)
+            results[batch_indices[i]] = std::move(delegate_results[i]);
+        }
+        catch (const fc::canceled_exception&)
+        {
+          throw;
+        }
+        catch (const fc::exception& e)
+        {
+          wlog("client failed to process a batch of transactions: ${e}", ("e", e));
+          for (size_t batch_index : batch_indices)
+            results[batch_index] = e;
+        }
+        fc::time_point message_validated_time = fc::time_point::now();
+
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+          const transaction_awaiting_ingress& transaction = batch[i];
+          if (results[i])
+          {
+            dlog("client rejected transaction ${hash}, ${e}", ("hash", transaction.message_hash)("e", *results[i]));
+            // record it so we don't try to fetch this item again
+            _recently_failed_items.insert(peer_connection::timestamped_item_id(item_id(trx_message_type, transaction.message_hash), fc::time_point::now()));
+            continue;
+          }
+          // the delegate validated the transaction, broadcast it to our other peers
+          message_propagation_data propagation_data{transaction.receive_time, message_validated_time, transaction.originating_node_id};
+          broadcast(transaction.transaction_message, propagation_data);
+        }
+      }
+    }
+
+    void node_impl::trigger_process_transaction_ingress()
+    {
+      VERIFY_CORRECT_THREAD();
+      if (!_node_is_shutting_down &&
+          (!_process_transaction_ingress_done.valid() || _process_transaction_ingress_done.ready()))
+        _process_transaction_ingress_done = fc::async([=](){ process_transaction_ingress(); }, "process_transaction_ingress");
+    }
+
     void node_impl::start_synchronizing_with_peer( const peer_connection_ptr& peer )
     {
       VERIFY_CORRECT_THREAD();
@@ -4354,6 +4748,25 @@ namespace graphene { namespace net { namespace detail {
         wlog( "Exception thrown while terminating Process backlog of sync items task, ignoring" );
       }
 
+      try
+      {
+        _process_transaction_ingress_done.cancel_and_wait("node_impl::close()");
+        dlog("Process transaction ingress task terminated");
+      }
+      catch ( const fc::canceled_exception& )
+      {
+        dlog("Process transaction ingress task terminated");
+      }
+      catch ( const fc::exception& e )
+      {
+        wlog( "Exception thrown while terminating Process transaction ingress task, ignoring: ${e}", ("e", e) );
+      }
+      catch (...)
+      {
+        wlog( "Exception thrown while terminating Process transaction ingress task, ignoring" );
+      }
+      _transactions_awaiting_ingress.clear();
+
       unsigned handle_message_call_count = 0;
       while( true )
       {
@@ -5902,11 +6315,21 @@ namespace graphene { namespace net { namespace detail {
       INVOKE_AND_COLLECT_STATISTICS(handle_block, block_message, sync_mode, contained_transaction_message_ids);
     }
 
+    void statistics_gathering_node_delegate_wrapper::prefetch_block( const graphene::net::block_message& block_message )
+    {
+      INVOKE_AND_COLLECT_STATISTICS(prefetch_block, block_message);
+    }
+
     void statistics_gathering_node_delegate_wrapper::handle_transaction( const graphene::net::trx_message& transaction_message )
     {
       INVOKE_AND_COLLECT_STATISTICS(handle_transaction, transaction_message);
     }
 
+    std::vector<fc::oexception> statistics_gathering_node_delegate_wrapper::handle_transactions( const std::vector<graphene::net::trx_message>& transaction_messages )
+    {
+      INVOKE_AND_COLLECT_STATISTICS(handle_transactions, transaction_messages);
+    }
+
     std::vector<item_hash_t> statistics_gathering_node_delegate_wrapper::get_block_ids(const std::vector<item_hash_t>& blockchain_synopsis,
                                                                                        uint32_t& remaining_item_count,
                                                                                        uint32_t limit /* = 2000 */)
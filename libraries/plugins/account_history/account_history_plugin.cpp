@@ -66,7 +66,10 @@ class account_history_plugin_impl
       flat_set<account_id_type> _tracked_accounts;
       bool _partial_operations = false;
       primary_index< simple_index< operation_history_object > >* _oho_index;
+      primary_index< account_transaction_history_index >* _ath_index;
       uint32_t _max_ops_per_account = -1;
+      bool _history_by_operation_type = false;
+      shared_ptr< account_history_operation_index > _operation_type_index;
    private:
       /** add one history record, then check and remove the earliest history record */
       void add_account_history( const account_id_type account_id, const operation_history_id_type op_id );
@@ -274,6 +277,97 @@ void account_history_plugin_impl::add_account_history( const account_id_type acc
 
 } // end namespace detail
 
+void account_history_operation_index::on_add( const object& obj )
+{
+   if( obj.id.space() == operation_history_object::space_id )
+   {
+      auto itr = _unresolved.find( obj.id );
+      if( itr == _unresolved.end() )
+         return;
+      const auto& oho = static_cast<const operation_history_object&>( obj );
+      for( const auto& account : itr->second )
+         add( account, oho.id, oho.op.which() );
+      _unresolved.erase( itr );
+      return;
+   }
+
+   const auto& ath = static_cast<const account_transaction_history_object&>( obj );
+   const operation_history_object* oho = _db.find( ath.operation_id );
+   if( oho != nullptr )
+      add( ath.account, ath.operation_id, oho->op.which() );
+   else
+      _unresolved[ath.operation_id].insert( ath.account );
+}
+
+void account_history_operation_index::on_remove( const object& obj )
+{
+   if( obj.id.space() == operation_history_object::space_id )
+      return;
+
+   const auto& ath = static_cast<const account_transaction_history_object&>( obj );
+   auto unresolved = _unresolved.find( ath.operation_id );
+   if( unresolved != _unresolved.end() )
+   {
+      unresolved->second.erase( ath.account );
+      if( unresolved->second.empty() )
+         _unresolved.erase( unresolved );
+   }
+
+   // the operation may already be gone, so look the entry up in every type used by the account
+   auto itr = _history_by_type.lower_bound( std::make_pair( ath.account, std::numeric_limits<int>::min() ) );
+   while( itr != _history_by_type.end() && itr->first.first == ath.account )
+   {
+      if( itr->second.erase( ath.operation_id ) && itr->second.empty() )
+         itr = _history_by_type.erase( itr );
+      else
+         ++itr;
+   }
+}
+
+void account_history_operation_index::add( account_id_type account, operation_history_id_type op_id, int operation_type )
+{
+   _history_by_type[std::make_pair( account, operation_type )].insert( op_id );
+}
+
+vector<operation_history_id_type> account_history_operation_index::get_operations( account_id_type account,
+                                                                                  const flat_set<int>& operation_types,
+                                                                                  operation_history_id_type start,
+                                                                                  operation_history_id_type stop,
+                                                                                  uint32_t limit )const
+{
+   typedef set<operation_history_id_type>::const_reverse_iterator history_iterator;
+   vector< std::pair<history_iterator, history_iterator> > cursors;
+   for( int operation_type : operation_types )
+   {
+      auto itr = _history_by_type.find( std::make_pair( account, operation_type ) );
+      if( itr == _history_by_type.end() )
+         continue;
+      const auto& ops = itr->second;
+      if( start == operation_history_id_type() )
+         cursors.emplace_back( ops.rbegin(), ops.rend() );
+      else
+         cursors.emplace_back( history_iterator( ops.upper_bound( start ) ), ops.rend() );
+   }
+
+   // merge the histories of the requested types, most recent first
+   vector<operation_history_id_type> result;
+   while( result.size() < limit )
+   {
+      auto next = cursors.end();
+      for( auto cursor = cursors.begin(); cursor != cursors.end(); ++cursor )
+         if( cursor->first != cursor->second && ( next == cursors.end() || *next->first < *cursor->first ) )
+            next = cursor;
+      if( next == cursors.end() )
+         break;
+      const operation_history_id_type op_id = *next->first;
+      if( stop != operation_history_id_type() && op_id.instance.value <= stop.instance.value )
+         break;
+      result.push_back( op_id );
+      ++next->first;
+   }
+   return result;
+}
+
 
 
 
@@ -302,6 +396,7 @@ void account_history_plugin::plugin_set_program_options(
          ("track-account", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(), "Account ID to track history for (may specify multiple times)")
          ("partial-operations", boost::program_options::value<bool>(), "Keep only those operations in memory that are related to account history tracking")
          ("max-ops-per-account", boost::program_options::value<uint32_t>(), "Maximum number of operations per account will be kept in memory")
+         ("history-by-operation-type", boost::program_options::value<bool>()->default_value(false), "Index account history by operation type to speed up queries filtered by operation type")
          ;
    cfg.add(cli);
 }
@@ -310,7 +405,7 @@ void account_history_plugin::plugin_initialize(const boost::program_options::var
 {
    database().applied_block.connect( [&]( const signed_block& b){ my->update_account_histories(b); } );
    my->_oho_index = database().add_index< primary_index< simple_index< operation_history_object > > >();
-   database().add_index< primary_index< account_transaction_history_index > >();
+   my->_ath_index = database().add_index< primary_index< account_transaction_history_index > >();
 
    LOAD_VALUE_SET(options, "track-account", my->_tracked_accounts, graphene::chain::account_id_type);
    if (options.count("partial-operations")) {
@@ -319,10 +414,23 @@ void account_history_plugin::plugin_initialize(const boost::program_options::var
    if (options.count("max-ops-per-account")) {
        my->_max_ops_per_account = options["max-ops-per-account"].as<uint32_t>();
    }
+   if (options.count("history-by-operation-type")) {
+       my->_history_by_operation_type = options["history-by-operation-type"].as<bool>();
+   }
 }
 
 void account_history_plugin::plugin_startup()
 {
+   if( my->_history_by_operation_type )
+   {
+      // the database is open by now, index what it already holds before following changes
+      my->_operation_type_index = std::make_shared<account_history_operation_index>( database() );
+      my->_ath_index->inspect_all_objects( [this]( const object& obj ) {
+         my->_operation_type_index->on_add( obj );
+      });
+      my->_ath_index->add_observer( my->_operation_type_index );
+      my->_oho_index->add_observer( my->_operation_type_index );
+   }
 }
 
 flat_set<account_id_type> account_history_plugin::tracked_accounts() const
@@ -330,4 +438,9 @@ flat_set<account_id_type> account_history_plugin::tracked_accounts() const
    return my->_tracked_accounts;
 }
 
+const account_history_operation_index* account_history_plugin::operation_type_index() const
+{
+   return my->_operation_type_index.get();
+}
+
 } }
@@ -53,7 +53,9 @@ namespace graphene { namespace account_history {
 enum account_history_object_type
 {
    key_account_object_type = 0,
-   bucket_object_type = 1 ///< used in market_history_plugin
+   bucket_object_type = 1, ///< used in market_history_plugin
+   market_ticker_object_type = 2, ///< used in market_history_plugin
+   market_ticker_meta_object_type = 3 ///< used in market_history_plugin
 };
 
 
@@ -62,6 +64,41 @@ namespace detail
     class account_history_plugin_impl;
 }
 
+/**
+ *  @brief Tracks the history of every account grouped by operation type
+ *
+ *  Observes the account_transaction_history_object and operation_history_object indexes and keeps,
+ *  for each (account, operation type) pair, the ids of the operations in the account history.  This
+ *  lets a query for a few operations of one type skip every operation of the other types.
+ *
+ *  Enabled with the history-by-operation-type option.
+ */
+class account_history_operation_index : public graphene::db::index_observer
+{
+   public:
+      account_history_operation_index( const graphene::chain::database& db ) : _db(db) {}
+
+      virtual void on_add( const object& obj ) override;
+      virtual void on_remove( const object& obj ) override;
+
+      /**
+       *  @return operations of the given types in the history of account, most recent first, starting at start
+       *  (or the most recent operation when start is 0) and stopping after stop (or at the first operation
+       *  when stop is 0)
+       */
+      vector<operation_history_id_type> get_operations( account_id_type account, const flat_set<int>& operation_types,
+                                                        operation_history_id_type start, operation_history_id_type stop,
+                                                        uint32_t limit )const;
+
+   private:
+      void add( account_id_type account, operation_history_id_type op_id, int operation_type );
+
+      const graphene::chain::database& _db;
+      map< std::pair<account_id_type, int>, set<operation_history_id_type> > _history_by_type;
+      /// history entries added while their operation did not exist yet, which happens when undo restores both
+      map< operation_history_id_type, flat_set<account_id_type> > _unresolved;
+};
+
 class account_history_plugin : public graphene::app::plugin
 {
    public:
@@ -76,6 +113,8 @@ class account_history_plugin : public graphene::app::plugin
       virtual void plugin_startup() override;
 
       flat_set<account_id_type> tracked_accounts()const;
+      /// @return the index of account history by operation type, or nullptr if it is not maintained
+      const account_history_operation_index* operation_type_index()const;
 
       friend class detail::account_history_plugin_impl;
       std::unique_ptr<detail::account_history_plugin_impl> my;
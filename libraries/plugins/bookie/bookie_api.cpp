@@ -52,6 +52,7 @@ class bookie_api_impl
       std::shared_ptr<graphene::bookie::bookie_plugin> get_plugin();
       asset get_total_matched_bet_amount_for_betting_market_group(betting_market_group_id_type group_id);
       std::vector<event_object> get_events_containing_sub_string(const std::string& sub_string, const std::string& language);
+      std::vector<event_object> search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit);
       fc::variants get_objects(const vector<object_id_type>& ids) const;
       std::vector<matched_bet_object> get_matched_bets_for_bettor(account_id_type bettor_id) const;
       std::vector<matched_bet_object> get_all_matched_bets_for_bettor(account_id_type bettor_id, bet_id_type start, unsigned limit) const;
@@ -65,7 +66,7 @@ bookie_api_impl::bookie_api_impl(graphene::app::application& _app) : app(_app)
 binned_order_book bookie_api_impl::get_binned_order_book(graphene::chain::betting_market_id_type betting_market_id, int32_t precision)
 {
     std::shared_ptr<graphene::chain::database> db = app.chain_database();
-    const auto& bet_odds_idx = db->get_index_type<graphene::chain::bet_object_index>().indices().get<graphene::chain::by_odds>();
+    const auto& order_books = db->get_index_type<graphene::chain::primary_index<graphene::chain::bet_object_index> >().get_secondary_index<graphene::chain::bet_order_book_index>();
     const chain_parameters& current_params = db->get_global_properties().parameters;
 
     graphene::chain::bet_multiplier_type bin_size = GRAPHENE_BETTING_ODDS_PRECISION;
@@ -103,33 +104,31 @@ binned_order_book bookie_api_impl::get_binned_order_book(graphene::chain::bettin
         }
     };
 
-    // iterate through both sides of the order book (backs at increasing odds then lays at decreasing odds)
-    for (auto bet_odds_iter = bet_odds_idx.lower_bound(std::make_tuple(betting_market_id));
-         bet_odds_iter != bet_odds_idx.end() && betting_market_id == bet_odds_iter->betting_market_id;
-         ++bet_odds_iter)
+    // bets at one price level always fall into the same bin, so add whole levels at a time
+    auto add_price_level = [&](bet_type back_or_lay, graphene::chain::bet_multiplier_type backer_multiplier, share_type amount_to_bet)
     {
         if (current_bin && 
-            (bet_odds_iter->back_or_lay != current_bin->back_or_lay /* we have switched from back to lay bets */ ||
-             (bet_odds_iter->back_or_lay == bet_type::back ? bet_odds_iter->backer_multiplier > current_bin->backer_multiplier :
-                                                             bet_odds_iter->backer_multiplier < current_bin->backer_multiplier)))
+            (back_or_lay != current_bin->back_or_lay /* we have switched from back to lay bets */ ||
+             (back_or_lay == bet_type::back ? backer_multiplier > current_bin->backer_multiplier :
+                                              backer_multiplier < current_bin->backer_multiplier)))
             flush_current_bin();
 
         if (!current_bin)
         {
-            // if there is no current bin, create one appropriate for the bet we're processing
+            // if there is no current bin, create one appropriate for the level we're processing
             current_bin = graphene::chain::bet_object();
 
             // for back bets, we want to group all bets with odds from 3.0001 to 4 into the "4" bin
             // for lay bets, we want to group all bets with odds from 3 to 3.9999 into the "3" bin
-            if (bet_odds_iter->back_or_lay == bet_type::back)
+            if (back_or_lay == bet_type::back)
             {
-               current_bin->backer_multiplier = (bet_odds_iter->backer_multiplier + bin_size - 1) / bin_size * bin_size;
+               current_bin->backer_multiplier = (backer_multiplier + bin_size - 1) / bin_size * bin_size;
                current_bin->backer_multiplier = std::min<graphene::chain::bet_multiplier_type>(current_bin->backer_multiplier, current_params.max_bet_multiplier());
                current_bin->back_or_lay = bet_type::back;
             }
             else
             {
-               current_bin->backer_multiplier = bet_odds_iter->backer_multiplier / bin_size * bin_size;
+               current_bin->backer_multiplier = backer_multiplier / bin_size * bin_size;
                current_bin->backer_multiplier = std::max<graphene::chain::bet_multiplier_type>(current_bin->backer_multiplier, current_params.min_bet_multiplier());
                current_bin->back_or_lay = bet_type::lay;
             }
@@ -137,7 +136,16 @@ binned_order_book bookie_api_impl::get_binned_order_book(graphene::chain::bettin
             current_bin->amount_to_bet.amount = 0;
         }
 
-        current_bin->amount_to_bet.amount += bet_odds_iter->amount_to_bet.amount;
+        current_bin->amount_to_bet.amount += amount_to_bet;
+    };
+
+    // walk both sides of the order book (backs at increasing odds then lays at decreasing odds)
+    if (const graphene::chain::bet_order_book_index::order_book* order_book = order_books.get_order_book(betting_market_id))
+    {
+        for (const auto& level : order_book->back_levels)
+            add_price_level(bet_type::back, level.first, level.second.amount_to_bet);
+        for (const auto& level : order_book->lay_levels)
+            add_price_level(bet_type::lay, level.first, level.second.amount_to_bet);
     }
     if (current_bin)
         flush_current_bin();
@@ -286,6 +294,12 @@ std::vector<event_object> bookie_api_impl::get_events_containing_sub_string(cons
    return get_plugin()->get_events_containing_sub_string(sub_string, language);
 }
 
+std::vector<event_object> bookie_api_impl::search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit)
+{
+   FC_ASSERT(limit <= 100, "limit must not exceed 100");
+   return get_plugin()->search_events(query, language, skip, limit);
+}
+
 } // detail
 
 bookie_api::bookie_api(graphene::app::application& app) :
@@ -308,6 +322,11 @@ std::vector<event_object> bookie_api::get_events_containing_sub_string(const std
    return my->get_events_containing_sub_string(sub_string, language);
 }
 
+std::vector<event_object> bookie_api::search_events(const std::string& query, const std::string& language, uint32_t skip /* = 0 */, uint32_t limit /* = 100 */)
+{
+   return my->search_events(query, language, skip, limit);
+}
+
 fc::variants bookie_api::get_objects(const vector<object_id_type>& ids) const
 {
    return my->get_objects(ids);
@@ -23,6 +23,7 @@
  */
 #include <graphene/bookie/bookie_plugin.hpp>
 #include <graphene/bookie/bookie_objects.hpp>
+#include <graphene/bookie/event_name_index.hpp>
 
 #include <graphene/chain/impacted.hpp>
 
@@ -34,8 +35,6 @@
 #include <graphene/chain/operation_history_object.hpp>
 #include <graphene/chain/transaction_evaluation_state.hpp>
 
-#include <boost/algorithm/string/case_conv.hpp>
-
 #include <fc/thread/thread.hpp>
 
 #include <boost/polymorphic_cast.hpp>
@@ -164,24 +163,15 @@ class bookie_plugin_impl
 
       std::vector<event_object> get_events_containing_sub_string(const std::string& sub_string, const std::string& language);
 
+      std::vector<event_object> search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit);
+
       graphene::chain::database& database()
       {
          return _self.database();
       }
 
-      //                1.18.          "Washington Capitals/Chicago Blackhawks"
-      typedef std::pair<event_id_type, std::string> event_string;
-      struct event_string_less : public std::less<const event_string&>
-      {
-          bool operator()(const event_string &_left, const event_string &_right) const
-          {
-              return (_left.first.instance < _right.first.instance);
-          }
-      };
-
-      typedef flat_set<event_string, event_string_less> event_string_set;
-      //       "en"
-      std::map<std::string, event_string_set> localized_event_strings;
+      // event names by language, e.g. "en" -> 1.18.x -> "Washington Capitals/Chicago Blackhawks"
+      event_name_index localized_event_names;
 
       bookie_plugin& _self;
       flat_set<account_id_type> _tracked_accounts;
@@ -197,6 +187,9 @@ void bookie_plugin_impl::on_objects_new(const vector<object_id_type>& new_object
 
 void bookie_plugin_impl::on_objects_removed(const vector<object_id_type>& removed_object_ids)
 {
+   for (const object_id_type& removed_object_id : removed_object_ids)
+      if (removed_object_id.is<event_id_type>())
+         localized_event_names.remove_event(removed_object_id);
 }
 
 void bookie_plugin_impl::on_objects_changed(const vector<object_id_type>& changed_object_ids)
@@ -285,7 +278,7 @@ void bookie_plugin_impl::on_block_applied( const signed_block& )
          FC_ASSERT( db.find_object(object_id), "invalid event specified" );
          const event_create_operation& event_create_op = op.op.get<event_create_operation>();
          for(const std::pair<std::string, std::string>& pair : event_create_op.name)
-            localized_event_strings[pair.first].insert(event_string(object_id, pair.second));
+            localized_event_names.set_name(object_id, pair.first, pair.second);
       }
       else if( op.op.which() == operation::tag<event_update_operation>::value )
       {
@@ -294,14 +287,7 @@ void bookie_plugin_impl::on_block_applied( const signed_block& )
             continue;
          event_id_type event_id = event_create_op.event_id;
          for(const std::pair<std::string, std::string>& pair : *event_create_op.new_name)
-         {
-            // try insert
-            std::pair<event_string_set::iterator, bool> result =
-               localized_event_strings[pair.first].insert(event_string(event_id, pair.second));
-            if (!result.second)
-               //  update string only
-               result.first->second = pair.second;
-         }
+            localized_event_names.set_name(event_id, pair.first, pair.second);
       }
       else if ( op.op.which() == operation::tag<bet_canceled_operation>::value )
       {
@@ -352,7 +338,7 @@ void bookie_plugin_impl::fill_localized_event_strings()
            ++event_itr;
            for(const std::pair<std::string, std::string>& pair : event_obj.name)
            {
-                localized_event_strings[pair.first].insert(event_string(event_obj.id, pair.second));
+                localized_event_names.set_name(event_obj.id, pair.first, pair.second);
            }
        }
 }
@@ -361,17 +347,17 @@ std::vector<event_object> bookie_plugin_impl::get_events_containing_sub_string(c
 {
    graphene::chain::database& db = database();
    std::vector<event_object> events;
-   if (localized_event_strings.find(language) != localized_event_strings.end())
-   {
-      std::string lower_case_sub_string = boost::algorithm::to_lower_copy(sub_string);
-      const event_string_set& language_set = localized_event_strings[language];
-      for (const event_string& pair : language_set)
-      {
-         std::string lower_case_string = boost::algorithm::to_lower_copy(pair.second);
-         if (lower_case_string.find(lower_case_sub_string) != std::string::npos)
-            events.push_back(pair.first(db));
-      }
-   }
+   for (const event_id_type& event_id : localized_event_names.find_containing(sub_string, language))
+      events.push_back(event_id(db));
+   return events;
+}
+
+std::vector<event_object> bookie_plugin_impl::search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit)
+{
+   graphene::chain::database& db = database();
+   std::vector<event_object> events;
+   for (const event_id_type& event_id : localized_event_names.search(query, language, skip, limit))
+      events.push_back(event_id(db));
    return events;
 }
 
@@ -457,5 +443,10 @@ std::vector<event_object> bookie_plugin::get_events_containing_sub_string(const
     return my->get_events_containing_sub_string(sub_string, language);
 }
 
+std::vector<event_object> bookie_plugin::search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit)
+{
+    return my->search_events(query, language, skip, limit);
+}
+
 } }
 
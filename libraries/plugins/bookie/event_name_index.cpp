@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Peerplays Blockchain Standards Association, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/bookie/event_name_index.hpp>
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace graphene { namespace bookie {
+
+namespace {
+   const size_t trigram_length = 3;
+}
+
+void event_name_index::for_each_trigram( const std::string& lower_case_name, const std::function<void(const std::string&)>& f )
+{
+   for (size_t pos = 0; pos + trigram_length <= lower_case_name.size(); ++pos)
+      f(lower_case_name.substr(pos, trigram_length));
+}
+
+void event_name_index::remove_name( language_index& index, event_id_type event_id )
+{
+   auto name_iter = index.names.find(event_id);
+   if (name_iter == index.names.end())
+      return;
+   for_each_trigram(name_iter->second, [&](const std::string& trigram) {
+      auto trigram_iter = index.events_by_trigram.find(trigram);
+      if (trigram_iter == index.events_by_trigram.end())
+         return;
+      trigram_iter->second.erase(event_id);
+      if (trigram_iter->second.empty())
+         index.events_by_trigram.erase(trigram_iter);
+   });
+   index.names.erase(name_iter);
+}
+
+void event_name_index::set_name( event_id_type event_id, const std::string& language, const std::string& name )
+{
+   language_index& index = _languages[language];
+   remove_name(index, event_id);
+
+   std::string lower_case_name = boost::algorithm::to_lower_copy(name);
+   for_each_trigram(lower_case_name, [&](const std::string& trigram) {
+      index.events_by_trigram[trigram].insert(event_id);
+   });
+   index.names.emplace(event_id, std::move(lower_case_name));
+}
+
+void event_name_index::remove_event( event_id_type event_id )
+{
+   for (auto& language : _languages)
+      remove_name(language.second, event_id);
+}
+
+std::vector<event_id_type> event_name_index::find_containing( const language_index& index, const std::string& lower_case_query )const
+{
+   std::vector<event_id_type> events;
+   auto contains_query = [&](const std::string& name) { return name.find(lower_case_query) != std::string::npos; };
+
+   if (lower_case_query.size() < trigram_length)
+   {
+      // too short to use the trigrams, but the names are already lower-cased
+      for (const auto& name : index.names)
+         if (contains_query(name.second))
+            events.push_back(name.first);
+      return events;
+   }
+
+   // every trigram of the query must appear in a matching name, so only the events under the
+   // query's least common trigram need to be checked
+   const flat_set<event_id_type>* candidates = nullptr;
+   bool missing_trigram = false;
+   for_each_trigram(lower_case_query, [&](const std::string& trigram) {
+      if (missing_trigram)
+         return;
+      auto trigram_iter = index.events_by_trigram.find(trigram);
+      if (trigram_iter == index.events_by_trigram.end())
+         missing_trigram = true;
+      else if (!candidates || trigram_iter->second.size() < candidates->size())
+         candidates = &trigram_iter->second;
+   });
+   if (missing_trigram || !candidates)
+      return events;
+
+   for (const event_id_type& event_id : *candidates)
+   {
+      auto name_iter = index.names.find(event_id);
+      if (name_iter != index.names.end() && contains_query(name_iter->second))
+         events.push_back(event_id);
+   }
+   return events;
+}
+
+std::vector<event_id_type> event_name_index::find_containing( const std::string& query, const std::string& language )const
+{
+   auto language_iter = _languages.find(language);
+   if (language_iter == _languages.end())
+      return std::vector<event_id_type>();
+   return find_containing(language_iter->second, boost::algorithm::to_lower_copy(query));
+}
+
+event_name_index::match_rank event_name_index::rank_match( const std::string& name, const std::string& lower_case_query )
+{
+   size_t pos = name.find(lower_case_query);
+   if (pos == 0)
+      return prefix_match;
+   for (; pos != std::string::npos; pos = name.find(lower_case_query, pos + 1))
+      if (!std::isalnum(static_cast<unsigned char>(name[pos - 1])))
+         return token_match;
+   return substring_match;
+}
+
+std::vector<event_id_type> event_name_index::search( const std::string& query, const std::string& language,
+                                                     uint32_t skip, uint32_t limit )const
+{
+   std::vector<event_id_type> results;
+   auto language_iter = _languages.find(language);
+   if (language_iter == _languages.end())
+      return results;
+
+   const language_index& index = language_iter->second;
+   const std::string lower_case_query = boost::algorithm::to_lower_copy(query);
+
+   std::vector<std::pair<match_rank, event_id_type>> ranked_events;
+   for (const event_id_type& event_id : find_containing(index, lower_case_query))
+      ranked_events.emplace_back(rank_match(index.names.at(event_id), lower_case_query), event_id);
+   std::sort(ranked_events.begin(), ranked_events.end());
+
+   for (size_t i = skip; i < ranked_events.size() && results.size() < limit; ++i)
+      results.push_back(ranked_events[i].second);
+   return results;
+}
+
+} } // graphene::bookie
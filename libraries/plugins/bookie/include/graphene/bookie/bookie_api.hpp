@@ -90,6 +90,14 @@ class bookie_api
       binned_order_book get_binned_order_book(graphene::chain::betting_market_id_type betting_market_id, int32_t precision);
       asset get_total_matched_bet_amount_for_betting_market_group(betting_market_group_id_type group_id);
       std::vector<event_object> get_events_containing_sub_string(const std::string& sub_string, const std::string& language);
+      /**
+       * Returns the events whose name in the given language contains the query, ignoring case.
+       * Names starting with the query come first, then names with a word starting with the query,
+       * then any other match; ties are ordered by event id.
+       * @param skip number of ranked results to skip, for paging
+       * @param limit maximum number of events to return, at most 100
+       */
+      std::vector<event_object> search_events(const std::string& query, const std::string& language, uint32_t skip = 0, uint32_t limit = 100);
       fc::variants get_objects(const vector<object_id_type>& ids)const;
       std::vector<matched_bet_object> get_matched_bets_for_bettor(account_id_type bettor_id) const;
       std::vector<matched_bet_object> get_all_matched_bets_for_bettor(account_id_type bettor_id, bet_id_type start = bet_id_type(), unsigned limit = 1000) const;
@@ -106,6 +114,7 @@ FC_API(graphene::bookie::bookie_api,
        (get_binned_order_book)
        (get_total_matched_bet_amount_for_betting_market_group)
        (get_events_containing_sub_string)
+       (search_events)
        (get_objects)
        (get_matched_bets_for_bettor)
        (get_all_matched_bets_for_bettor))
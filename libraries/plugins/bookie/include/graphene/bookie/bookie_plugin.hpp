@@ -65,6 +65,7 @@ class bookie_plugin : public graphene::app::plugin
       flat_set<account_id_type> tracked_accounts()const;
       asset get_total_matched_bet_amount_for_betting_market_group(betting_market_group_id_type group_id);
       std::vector<event_object> get_events_containing_sub_string(const std::string& sub_string, const std::string& language);
+      std::vector<event_object> search_events(const std::string& query, const std::string& language, uint32_t skip, uint32_t limit);
 
       friend class detail::bookie_plugin_impl;
       std::unique_ptr<detail::bookie_plugin_impl> my;
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018 Peerplays Blockchain Standards Association, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/protocol/types.hpp>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graphene { namespace bookie {
+using namespace chain;
+
+/**
+ * Searchable index of event names, kept per language.  Names are stored lower-cased, and each
+ * three-character substring (trigram) of a name maps to the events whose name contains it, so a
+ * query only has to check the events sharing the query's least common trigram.
+ */
+class event_name_index
+{
+   public:
+      /// how well a name matches a query, best first
+      enum match_rank
+      {
+         prefix_match = 0,    ///< the name starts with the query
+         token_match = 1,     ///< a word in the name starts with the query
+         substring_match = 2  ///< the query appears elsewhere in the name
+      };
+
+      /// sets or replaces the name of an event in one language
+      void set_name( event_id_type event_id, const std::string& language, const std::string& name );
+      /// drops the event from every language
+      void remove_event( event_id_type event_id );
+
+      /// returns every event whose name contains the query (ignoring case), ordered by event id
+      std::vector<event_id_type> find_containing( const std::string& query, const std::string& language )const;
+
+      /**
+       * Returns the events whose name contains the query (ignoring case), ranked by match_rank and then
+       * by event id, skipping the first @p skip results and returning at most @p limit.
+       */
+      std::vector<event_id_type> search( const std::string& query, const std::string& language,
+                                         uint32_t skip, uint32_t limit )const;
+
+   private:
+      struct language_index
+      {
+         std::map<event_id_type, std::string>                         names;
+         std::unordered_map<std::string, flat_set<event_id_type>>   events_by_trigram;
+      };
+
+      static match_rank rank_match( const std::string& name, const std::string& lower_case_query );
+      static void for_each_trigram( const std::string& lower_case_name, const std::function<void(const std::string&)>& f );
+
+      void remove_name( language_index& index, event_id_type event_id );
+      /// events whose lower-cased name contains the lower-cased query, ordered by event id
+      std::vector<event_id_type> find_containing( const language_index& index, const std::string& lower_case_query )const;
+
+      std::map<std::string, language_index> _languages;
+};
+
+} } // graphene::bookie
@@ -30,6 +30,8 @@
 #include <fc/thread/future.hpp>
 #include <fc/container/flat.hpp>
 
+#include <fstream>
+
 namespace graphene { namespace debug_witness_plugin {
 
 class debug_witness_plugin : public graphene::app::plugin {
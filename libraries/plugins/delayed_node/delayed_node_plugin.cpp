@@ -121,8 +121,7 @@ void delayed_node_plugin::sync_with_trusted_node()
          // TODO: during sync, decouple requesting blocks from preprocessing + applying them
          FC_ASSERT(block, "Trusted node claims it has blocks it doesn't actually have.");
          ilog("Pushing block #${n}", ("n", block->block_num()));
-         // timur: failed to merge from bitshares, API n/a in peerplays
-         // db.precompute_parallel( *block, graphene::chain::database::skip_nothing ).wait();
+         db.precompute_parallel( *block, graphene::chain::database::skip_nothing ).wait();
          db.push_block(*block);
          synced_blocks++;
       }
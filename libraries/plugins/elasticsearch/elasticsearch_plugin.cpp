@@ -48,7 +48,7 @@ class elasticsearch_plugin_impl
    public:
       elasticsearch_plugin_impl(elasticsearch_plugin& _plugin)
          : _self( _plugin )
-      {  curl = curl_easy_init(); }
+      {  }
       virtual ~elasticsearch_plugin_impl();
 
       bool update_account_histories( const signed_block& b );
@@ -74,11 +74,13 @@ class elasticsearch_plugin_impl
       uint32_t _elasticsearch_start_es_after_block = 0;
       bool _elasticsearch_operation_string = false;
       mode _elasticsearch_mode = mode::only_save;
-      CURL *curl; // curl handler
+      uint32_t _elasticsearch_flush_interval = 1000;
+      uint32_t _elasticsearch_queue_size = 64;
+      std::string _elasticsearch_spool_dir = "";
       vector <string> bulk_lines; //  vector of op lines
       vector<std::string> prepare;
 
-      graphene::utilities::ES es;
+      std::unique_ptr<graphene::utilities::BulkExporter> exporter; // sends bulk_lines off the chain thread
       uint32_t limit_documents;
       int16_t op_type;
       operation_history_struct os;
@@ -105,15 +107,15 @@ class elasticsearch_plugin_impl
       void cleanObjects(const account_transaction_history_id_type& ath, const account_id_type& account_id);
       void createBulkLine(const account_transaction_history_object& ath);
       void prepareBulk(const account_transaction_history_id_type& ath_id);
-      void populateESstruct();
+      bool sendBulk();
       void init_program_options(const boost::program_options::variables_map& options);
 };
 
 elasticsearch_plugin_impl::~elasticsearch_plugin_impl()
 {
-   if (curl) {
-      curl_easy_cleanup(curl);
-      curl = nullptr;
+   if (exporter) {
+      sendBulk();
+      exporter.reset();
    }
    return;
 }
@@ -196,26 +198,12 @@ bool elasticsearch_plugin_impl::update_account_histories( const signed_block& b
       }
    }
    // we send bulk at end of block when we are in sync for better real time client experience
-   if(is_sync)
+   if(is_sync && !bulk_lines.empty())
    {
-      populateESstruct();
-      if(es.bulk_lines.size() > 0)
-      {
-         prepare.clear();
-         if(!graphene::utilities::SendBulk(es))
-         {
-            // Note: although called with `std::move()`, `es` is not updated in `SendBulk()`
-            elog( "Error sending ${n} lines of bulk data to Elastic Search, the first lines are:",
-                  ("n",es.bulk_lines.size()) );
-            for( size_t i = 0; i < es.bulk_lines.size() && i < 10; ++i )
-            {
-               edump( (es.bulk_lines[i]) );
-            }
-            return false;
-         }
-         else
-            bulk_lines.clear();
-      }
+      prepare.clear();
+      if(!sendBulk())
+         return false;
+      exporter->flush();
    }
 
    if(bulk_lines.size() != limit_documents)
@@ -486,22 +474,10 @@ bool elasticsearch_plugin_impl::add_elasticsearch( const account_id_type account
    }
    cleanObjects(ath.id, account_id);
 
-   if (curl && bulk_lines.size() >= limit_documents) { // we are in bulk time, ready to add data to elasticsearech
+   if (bulk_lines.size() >= limit_documents) { // we are in bulk time, ready to add data to elasticsearech
       prepare.clear();
-      populateESstruct();
-      if(!graphene::utilities::SendBulk(es))
-      {
-         // Note: although called with `std::move()`, `es` is not updated in `SendBulk()`
-         elog( "Error sending ${n} lines of bulk data to Elastic Search, the first lines are:",
-               ("n",es.bulk_lines.size()) );
-         for( size_t i = 0; i < es.bulk_lines.size() && i < 10; ++i )
-         {
-            edump( (es.bulk_lines[i]) );
-         }
+      if(!sendBulk())
          return false;
-      }
-      else
-         bulk_lines.clear();
    }
 
    return true;
@@ -595,15 +571,16 @@ void elasticsearch_plugin_impl::cleanObjects(const account_transaction_history_i
    }
 }
 
-void elasticsearch_plugin_impl::populateESstruct()
+bool elasticsearch_plugin_impl::sendBulk()
 {
-   es.curl = curl;
-   es.bulk_lines = std::move(bulk_lines);
-   es.elasticsearch_url = _elasticsearch_node_url;
-   es.auth = _elasticsearch_basic_auth;
-   es.index_prefix = _elasticsearch_index_prefix;
-   es.endpoint = "";
-   es.query = "";
+   // hands the lines over to the exporter thread, the chain thread never waits on Elastic Search
+   if (exporter && !exporter->enqueue(std::move(bulk_lines))) {
+      // the lines are kept and handed over again with the next bulk
+      elog( "Elastic Search export queue is full, keeping ${n} lines of bulk data", ("n",bulk_lines.size()) );
+      return false;
+   }
+   bulk_lines.clear();
+   return true;
 }
 
 void elasticsearch_plugin_impl::init_program_options(const boost::program_options::variables_map& options)
@@ -641,6 +618,15 @@ void elasticsearch_plugin_impl::init_program_options(const boost::program_option
          FC_THROW_EXCEPTION(graphene::chain::plugin_exception, "Elasticsearch mode not valid");
       _elasticsearch_mode = static_cast<mode>(options["elasticsearch-mode"].as<uint16_t>());
    }
+   if (options.count("elasticsearch-flush-interval")) {
+      _elasticsearch_flush_interval = options["elasticsearch-flush-interval"].as<uint32_t>();
+   }
+   if (options.count("elasticsearch-queue-size")) {
+      _elasticsearch_queue_size = options["elasticsearch-queue-size"].as<uint32_t>();
+   }
+   if (options.count("elasticsearch-spool-dir")) {
+      _elasticsearch_spool_dir = options["elasticsearch-spool-dir"].as<std::string>();
+   }
 }
 
 } // end namespace detail
@@ -689,6 +675,12 @@ void elasticsearch_plugin::plugin_set_program_options(
                "Save operation as string. Needed to serve history api calls(false)")
          ("elasticsearch-mode", boost::program_options::value<uint16_t>(),
                "Mode of operation: only_save(0), only_query(1), all(2) - Default: 0")
+         ("elasticsearch-flush-interval", boost::program_options::value<uint32_t>(),
+               "Maximum time in milliseconds documents wait before being sent(1000)")
+         ("elasticsearch-queue-size", boost::program_options::value<uint32_t>(),
+               "Number of bulks buffered for the export thread before block processing fails and is retried(64)")
+         ("elasticsearch-spool-dir", boost::program_options::value<std::string>(),
+               "Directory where bulks are kept while Elastic Search is unreachable and rejected bulks are saved('')")
          ;
    cfg.add(cli);
 }
@@ -715,14 +707,28 @@ void elasticsearch_plugin::plugin_initialize(const boost::program_options::varia
    }
 
    graphene::utilities::ES es;
-   es.curl = my->curl;
+   es.curl = curl_easy_init();
    es.elasticsearch_url = my->_elasticsearch_node_url;
    es.auth = my->_elasticsearch_basic_auth;
 
-   if(!graphene::utilities::checkES(es))
+   // the handle is only needed for these checks, bulk data goes through the exporter's own connection
+   const bool es_is_up = graphene::utilities::checkES(es);
+   if(es_is_up)
+      graphene::utilities::checkESVersion7OrAbove(es, my->is_es_version_7_or_above);
+   curl_easy_cleanup(es.curl);
+   if(!es_is_up)
       FC_THROW_EXCEPTION(fc::exception, "ES database is not up in url ${url}", ("url", my->_elasticsearch_node_url));
 
-   graphene::utilities::checkESVersion7OrAbove(es, my->is_es_version_7_or_above);
+   if(my->_elasticsearch_mode != mode::only_query) {
+      graphene::utilities::BulkExporter::Config config;
+      config.elasticsearch_url = my->_elasticsearch_node_url;
+      config.auth = my->_elasticsearch_basic_auth;
+      config.batch_size = std::max(my->_elasticsearch_bulk_replay, my->_elasticsearch_bulk_sync);
+      config.flush_interval_ms = my->_elasticsearch_flush_interval;
+      config.queue_size = my->_elasticsearch_queue_size;
+      config.spool_dir = my->_elasticsearch_spool_dir;
+      my->exporter.reset( new graphene::utilities::BulkExporter( config ) );
+   }
 
    ilog("elasticsearch ACCOUNT HISTORY: plugin_initialize() end");
 }
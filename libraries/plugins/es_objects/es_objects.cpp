@@ -59,7 +59,7 @@ class es_objects_plugin_impl
    public:
       es_objects_plugin_impl(es_objects_plugin& _plugin)
          : _self( _plugin )
-      {  curl = curl_easy_init(); }
+      {  }
       virtual ~es_objects_plugin_impl();
 
       bool index_database(const vector<object_id_type>& ids, std::string action);
@@ -92,10 +92,14 @@ class es_objects_plugin_impl
 
       std::string _es_objects_index_prefix = "ppobjects-";
       uint32_t _es_objects_start_es_after_block = 0;
-      CURL *curl; // curl handler
+      uint32_t _es_objects_flush_interval = 1000;
+      uint32_t _es_objects_queue_size = 64;
+      std::string _es_objects_spool_dir = "";
       vector <std::string> bulk;
       vector<std::string> prepare;
 
+      std::unique_ptr<graphene::utilities::BulkExporter> exporter; // sends bulk off the chain thread
+
       bool _es_objects_keep_only_current = true;
 
       uint32_t block_number;
@@ -106,6 +110,7 @@ class es_objects_plugin_impl
       template<typename T>
       void prepareTemplate(T blockchain_object, string index_name);
       void init_program_options(const boost::program_options::variables_map& options);
+      bool sendBulk();
 };
 
 bool es_objects_plugin_impl::genesis()
@@ -271,15 +276,9 @@ bool es_objects_plugin_impl::genesis()
       });
    }
 
-   graphene::utilities::ES es;
-   es.curl = curl;
-   es.bulk_lines = bulk;
-   es.elasticsearch_url = _es_objects_elasticsearch_url;
-   es.auth = _es_objects_auth;
-   if (!graphene::utilities::SendBulk(es))
+   if (!sendBulk())
       FC_THROW_EXCEPTION(graphene::chain::plugin_exception, "Error inserting genesis data.");
-   else
-      bulk.clear();
+   exporter->flush();
 
    return true;
 }
@@ -503,18 +502,11 @@ bool es_objects_plugin_impl::index_database(const vector<object_id_type>& ids, s
          }
       }
 
-      if (curl && bulk.size() >= limit_documents) { // we are in bulk time, ready to add data to elasticsearech
-
-         graphene::utilities::ES es;
-         es.curl = curl;
-         es.bulk_lines = bulk;
-         es.elasticsearch_url = _es_objects_elasticsearch_url;
-         es.auth = _es_objects_auth;
-
-         if (!graphene::utilities::SendBulk(es))
+      if (bulk.size() >= limit_documents) { // we are in bulk time, ready to add data to elasticsearech
+         if (!sendBulk())
             return false;
-         else
-            bulk.clear();
+         if (limit_documents == _es_objects_bulk_sync)
+            exporter->flush();
       }
    }
 
@@ -568,12 +560,24 @@ void es_objects_plugin_impl::prepareTemplate(T blockchain_object, string index_n
 
 es_objects_plugin_impl::~es_objects_plugin_impl()
 {
-   if (curl) {
-      curl_easy_cleanup(curl);
-      curl = nullptr;
+   if (exporter) {
+      sendBulk();
+      exporter.reset();
    }
    return;
 }
+bool es_objects_plugin_impl::sendBulk()
+{
+   // hands the documents over to the exporter thread, the chain thread never waits on Elastic Search
+   if (exporter && !exporter->enqueue(std::move(bulk))) {
+      // the documents are kept and handed over again with the next bulk
+      elog( "Elastic Search export queue is full, keeping ${n} lines of bulk data", ("n",bulk.size()) );
+      return false;
+   }
+   bulk.clear();
+   return true;
+}
+
 void es_objects_plugin_impl::init_program_options(const boost::program_options::variables_map& options)
 {
    if (options.count("es-objects-elasticsearch-url")) {
@@ -639,6 +643,15 @@ void es_objects_plugin_impl::init_program_options(const boost::program_options::
    if (options.count("es-objects-start-es-after-block")) {
       _es_objects_start_es_after_block = options["es-objects-start-es-after-block"].as<uint32_t>();
    }
+   if (options.count("es-objects-flush-interval")) {
+      _es_objects_flush_interval = options["es-objects-flush-interval"].as<uint32_t>();
+   }
+   if (options.count("es-objects-queue-size")) {
+      _es_objects_queue_size = options["es-objects-queue-size"].as<uint32_t>();
+   }
+   if (options.count("es-objects-spool-dir")) {
+      _es_objects_spool_dir = options["es-objects-spool-dir"].as<std::string>();
+   }
 }
 
 } // end namespace detail
@@ -694,6 +707,12 @@ void es_objects_plugin::plugin_set_program_options(
                "Keep only current state of the objects(true)")
          ("es-objects-start-es-after-block", boost::program_options::value<uint32_t>(),
                "Start doing ES job after block(0)")
+         ("es-objects-flush-interval", boost::program_options::value<uint32_t>(),
+               "Maximum time in milliseconds documents wait before being sent(1000)")
+         ("es-objects-queue-size", boost::program_options::value<uint32_t>(),
+               "Number of bulks buffered for the export thread before block processing fails and is retried(64)")
+         ("es-objects-spool-dir", boost::program_options::value<std::string>(),
+               "Directory where bulks are kept while Elastic Search is unreachable and rejected bulks are saved('')")
          ;
    cfg.add(cli);
 }
@@ -736,15 +755,27 @@ void es_objects_plugin::plugin_initialize(const boost::program_options::variable
    });
 
    graphene::utilities::ES es;
-   es.curl = my->curl;
+   es.curl = curl_easy_init();
    es.elasticsearch_url = my->_es_objects_elasticsearch_url;
    es.auth = my->_es_objects_auth;
    es.auth = my->_es_objects_index_prefix;
 
-   if(!graphene::utilities::checkES(es))
+   // the handle is only needed for these checks, bulk data goes through the exporter's own connection
+   const bool es_is_up = graphene::utilities::checkES(es);
+   if(es_is_up)
+      graphene::utilities::checkESVersion7OrAbove(es, my->is_es_version_7_or_above);
+   curl_easy_cleanup(es.curl);
+   if(!es_is_up)
       FC_THROW_EXCEPTION(fc::exception, "ES database is not up in url ${url}", ("url", my->_es_objects_elasticsearch_url));
 
-   graphene::utilities::checkESVersion7OrAbove(es, my->is_es_version_7_or_above);
+   graphene::utilities::BulkExporter::Config config;
+   config.elasticsearch_url = my->_es_objects_elasticsearch_url;
+   config.auth = my->_es_objects_auth;
+   config.batch_size = std::max(my->_es_objects_bulk_replay, my->_es_objects_bulk_sync);
+   config.flush_interval_ms = my->_es_objects_flush_interval;
+   config.queue_size = my->_es_objects_queue_size;
+   config.spool_dir = my->_es_objects_spool_dir;
+   my->exporter.reset( new graphene::utilities::BulkExporter( config ) );
 
    ilog("elasticsearch OBJECTS: plugin_initialize() end");
 }
@@ -104,9 +104,48 @@ struct order_history_object : public abstract_object<order_history_object>
   history_key          key; 
   fc::time_point_sec   time;
   fill_order_operation op;
+
+  asset_id_type get_base()const { return key.base; }
+  asset_id_type get_quote()const { return key.quote; }
+  int64_t get_sequence()const { return key.sequence; }
+};
+
+/**
+ *  Trades of one market over the last 24 hours, updated as fills are applied and as trades leave the window, so
+ *  that tickers can be served without walking the order history.
+ *
+ *  As for buckets, base is the asset with the lower id and each match is counted once.
+ */
+struct market_ticker_object : public abstract_object<market_ticker_object>
+{
+   static const uint8_t space_id = ACCOUNT_HISTORY_SPACE_ID;
+   static const uint8_t type_id  = 2; // market_history_plugin type, referenced from account_history_plugin.hpp
+
+   asset_id_type       base;
+   asset_id_type       quote;
+   /// amounts of the latest trade
+   share_type          latest_base;
+   share_type          latest_quote;
+   /// amounts of the latest trade which left the 24 hours window, zero if none did
+   share_type          last_day_base;
+   share_type          last_day_quote;
+   share_type          base_volume;
+   share_type          quote_volume;
+};
+
+/// Tracks which order history entries have been counted out of the 24 hours tickers
+struct market_ticker_meta_object : public abstract_object<market_ticker_meta_object>
+{
+   static const uint8_t space_id = ACCOUNT_HISTORY_SPACE_ID;
+   static const uint8_t type_id  = 3; // market_history_plugin type, referenced from account_history_plugin.hpp
+
+   /// oldest order history entry still inside the window
+   object_id_type      rolling_min_order_his_id;
 };
 
 struct by_key;
+struct by_market;
+struct by_market_time;
 typedef multi_index_container<
    bucket_object,
    indexed_by<
@@ -118,14 +157,53 @@ typedef multi_index_container<
 typedef multi_index_container<
    order_history_object,
    indexed_by<
-      hashed_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
-      ordered_unique< tag<by_key>, member< order_history_object, history_key, &order_history_object::key > >
+      // ordered so that entries can be expired from the tickers in the order they were created
+      ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
+      ordered_unique< tag<by_key>, member< order_history_object, history_key, &order_history_object::key > >,
+      ordered_unique< tag<by_market_time>,
+         composite_key<
+            order_history_object,
+            const_mem_fun< order_history_object, asset_id_type, &order_history_object::get_base >,
+            const_mem_fun< order_history_object, asset_id_type, &order_history_object::get_quote >,
+            member< order_history_object, fc::time_point_sec, &order_history_object::time >,
+            const_mem_fun< order_history_object, int64_t, &order_history_object::get_sequence >
+         >,
+         composite_key_compare<
+            std::less< asset_id_type >,
+            std::less< asset_id_type >,
+            std::greater< fc::time_point_sec >,
+            std::less< int64_t >
+         >
+      >
    >
 > order_history_multi_index_type;
 
 
+typedef multi_index_container<
+   market_ticker_object,
+   indexed_by<
+      ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
+      ordered_unique< tag<by_market>,
+         composite_key<
+            market_ticker_object,
+            member< market_ticker_object, asset_id_type, &market_ticker_object::base >,
+            member< market_ticker_object, asset_id_type, &market_ticker_object::quote >
+         >
+      >
+   >
+> market_ticker_object_multi_index_type;
+
+typedef multi_index_container<
+   market_ticker_meta_object,
+   indexed_by<
+      ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >
+   >
+> market_ticker_meta_object_multi_index_type;
+
 typedef generic_index<bucket_object, bucket_object_multi_index_type> bucket_index;
 typedef generic_index<order_history_object, order_history_multi_index_type> history_index;
+typedef generic_index<market_ticker_object, market_ticker_object_multi_index_type> market_ticker_index;
+typedef generic_index<market_ticker_meta_object, market_ticker_meta_object_multi_index_type> market_ticker_meta_index;
 
 
 namespace detail
@@ -172,4 +250,10 @@ FC_REFLECT_DERIVED( graphene::market_history::bucket_object, (graphene::db::obje
                     (open_base)(open_quote)
                     (close_base)(close_quote)
                     (base_volume)(quote_volume) )
-
+FC_REFLECT_DERIVED( graphene::market_history::market_ticker_object, (graphene::db::object),
+                    (base)(quote)
+                    (latest_base)(latest_quote)
+                    (last_day_base)(last_day_quote)
+                    (base_volume)(quote_volume) )
+FC_REFLECT_DERIVED( graphene::market_history::market_ticker_meta_object, (graphene::db::object),
+                    (rolling_min_order_his_id) )
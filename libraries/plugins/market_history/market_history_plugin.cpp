@@ -52,6 +52,9 @@ class market_history_plugin_impl
        */
       void update_market_histories( const signed_block& b );
 
+      /** removes the trades which left the 24 hours window from the market tickers */
+      void expire_market_tickers( const signed_block& b );
+
       graphene::chain::database& database()
       {
          return _self.database();
@@ -96,31 +99,51 @@ struct operation_process_fill_order
 
       auto itr = history_idx.lower_bound( hkey );
 
-      if( itr->key.base == hkey.base && itr->key.quote == hkey.quote )
+      if( itr != history_idx.end() && itr->key.base == hkey.base && itr->key.quote == hkey.quote )
          hkey.sequence = itr->key.sequence - 1;
       else
          hkey.sequence = 0;
 
-      db.create<order_history_object>( [&]( order_history_object& ho ) {
+      const auto& new_history = db.create<order_history_object>( [&]( order_history_object& ho ) {
          ho.key = hkey;
          ho.time = time;
          ho.op = o;
       });
 
-      hkey.sequence += 200;
-      itr = history_idx.lower_bound( hkey );
-      /*
-      while( itr != history_idx.end() )
+      const auto& ticker_meta_idx = db.get_index_type<market_ticker_meta_index>().indices();
+      if( ticker_meta_idx.empty() )
+         db.create<market_ticker_meta_object>( [&]( market_ticker_meta_object& meta ) {
+            meta.rolling_min_order_his_id = new_history.id;
+         });
+
+      /** for every matched order there are two fill order operations created, one for
+       * each side.  Both are kept in the order history, tickers and buckets only consider
+       * the fill operations where the base < quote so that they count each trade once
+       */
+      if( o.pays.asset_id > o.receives.asset_id )
       {
-         if( itr->key.base == hkey.base && itr->key.quote == hkey.quote )
-         {
-            db.remove( *itr );
-            itr = history_idx.lower_bound( hkey );
-         }
-         else break;
+         //ilog( "     skipping because base > quote" );
+         return;
       }
-      */
 
+      const auto& ticker_idx = db.get_index_type<market_ticker_index>().indices().get<by_market>();
+      auto ticker_itr = ticker_idx.find( std::make_tuple( o.pays.asset_id, o.receives.asset_id ) );
+      if( ticker_itr == ticker_idx.end() )
+         db.create<market_ticker_object>( [&]( market_ticker_object& t ) {
+            t.base = o.pays.asset_id;
+            t.quote = o.receives.asset_id;
+            t.latest_base = o.pays.amount;
+            t.latest_quote = o.receives.amount;
+            t.base_volume = o.pays.amount;
+            t.quote_volume = o.receives.amount;
+         });
+      else
+         db.modify( *ticker_itr, [&]( market_ticker_object& t ) {
+            t.latest_base = o.pays.amount;
+            t.latest_quote = o.receives.amount;
+            t.base_volume += o.pays.amount;
+            t.quote_volume += o.receives.amount;
+         });
 
       auto max_history = _plugin.max_history();
       for( auto bucket : buckets )
@@ -131,17 +154,6 @@ struct operation_process_fill_order
           key.base    = o.pays.asset_id;
           key.quote   = o.receives.asset_id;
 
-
-          /** for every matched order there are two fill order operations created, one for
-           * each side.  We can filter the duplicates by only considering the fill operations where
-           * the base > quote
-           */
-          if( key.base > key.quote ) 
-          {
-             //ilog( "     skipping because base > quote" );
-             continue;
-          }
-
           price trade_price = o.pays / o.receives;
 
           key.seconds = bucket;
@@ -225,6 +237,46 @@ void market_history_plugin_impl::update_market_histories( const signed_block& b
       if( o_op.valid() )
          o_op->op.visit( operation_process_fill_order( _self, b.timestamp ) );
    }
+
+   expire_market_tickers( b );
+}
+
+void market_history_plugin_impl::expire_market_tickers( const signed_block& b )
+{
+   graphene::chain::database& db = database();
+   const auto& meta_idx = db.get_index_type<market_ticker_meta_index>().indices();
+   if( meta_idx.empty() )
+      return;
+   const market_ticker_meta_object& meta = *meta_idx.begin();
+
+   const fc::time_point_sec cutoff = b.timestamp - 86400;
+   const auto& history = db.get_index_type<history_index>();
+   const auto& history_idx = history.indices().get<by_id>();
+   const auto& ticker_idx = db.get_index_type<market_ticker_index>().indices().get<by_market>();
+
+   // order history ids grow with time, so the entries leaving the window are at the front
+   auto itr = history_idx.lower_bound( meta.rolling_min_order_his_id );
+   for( ; itr != history_idx.end() && itr->time < cutoff; ++itr )
+   {
+      const fill_order_operation& o = itr->op;
+      if( !( o.pays.asset_id < o.receives.asset_id ) )
+         continue;
+      auto ticker_itr = ticker_idx.find( std::make_tuple( o.pays.asset_id, o.receives.asset_id ) );
+      if( ticker_itr == ticker_idx.end() )
+         continue;
+      db.modify( *ticker_itr, [&]( market_ticker_object& t ) {
+         t.base_volume -= o.pays.amount;
+         t.quote_volume -= o.receives.amount;
+         t.last_day_base = o.pays.amount;
+         t.last_day_quote = o.receives.amount;
+      });
+   }
+
+   const object_id_type rolling_min = ( itr == history_idx.end() ? history.get_next_id() : itr->id );
+   if( rolling_min != meta.rolling_min_order_his_id )
+      db.modify( meta, [&]( market_ticker_meta_object& m ) {
+         m.rolling_min_order_his_id = rolling_min;
+      });
 }
 
 } // end namespace detail
@@ -267,6 +319,8 @@ void market_history_plugin::plugin_initialize(const boost::program_options::vari
    database().applied_block.connect( [this]( const signed_block& b){ my->update_market_histories(b); } );
    database().add_index< primary_index< bucket_index  > >();
    database().add_index< primary_index< history_index  > >();
+   database().add_index< primary_index< market_ticker_index  > >();
+   database().add_index< primary_index< market_ticker_meta_index  > >();
 
    if( options.count( "bucket-size" ) )
    {
@@ -1,5 +1,8 @@
 #include <graphene/peerplays_sidechain/common/rpc_client.hpp>
 
+#include <cctype>
+#include <cstdlib>
+#include <memory>
 #include <regex>
 #include <sstream>
 
@@ -23,11 +26,156 @@ struct rpc_reply {
    std::string body;
 };
 
+namespace {
+
+// Beast limits response bodies to 8 MB by default, which batches of full blocks easily exceed
+const uint64_t max_response_body_size = 64 * 1024 * 1024;
+
+size_t skip_json_whitespace(const std::string &json, size_t pos) {
+   while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos])))
+      pos = pos + 1;
+   return pos;
+}
+
+// Returns the position just past the JSON value starting at pos, scanning the
+// text once without building a property tree, or npos if the value is malformed
+size_t skip_json_value(const std::string &json, size_t pos) {
+   pos = skip_json_whitespace(json, pos);
+   if (pos >= json.size())
+      return std::string::npos;
+
+   int depth = 0;
+   bool in_string = false;
+   for (; pos < json.size(); pos++) {
+      const char c = json[pos];
+      if (in_string) {
+         if (c == '\\') {
+            pos = pos + 1;
+         } else if (c == '"') {
+            in_string = false;
+            if (depth == 0)
+               return pos + 1;
+         }
+         continue;
+      }
+      switch (c) {
+      case '"':
+         in_string = true;
+         break;
+      case '{':
+      case '[':
+         depth = depth + 1;
+         break;
+      case '}':
+      case ']':
+         if (depth == 0)
+            return pos;
+         depth = depth - 1;
+         if (depth == 0)
+            return pos + 1;
+         break;
+      case ',':
+         if (depth == 0)
+            return pos;
+         break;
+      default:
+         if (depth == 0 && std::isspace(static_cast<unsigned char>(c)))
+            return pos;
+      }
+   }
+   return (depth == 0 && !in_string) ? pos : std::string::npos;
+}
+
+// Splits a JSON array into the raw text of its top level elements
+bool split_json_array(const std::string &json, std::vector<std::string> &elements) {
+   size_t pos = skip_json_whitespace(json, 0);
+   if (pos >= json.size() || json[pos] != '[')
+      return false;
+
+   pos = skip_json_whitespace(json, pos + 1);
+   if (pos < json.size() && json[pos] == ']')
+      return true;
+
+   while (pos < json.size()) {
+      const size_t end = skip_json_value(json, pos);
+      if (end == std::string::npos)
+         return false;
+      elements.push_back(json.substr(pos, end - pos));
+
+      pos = skip_json_whitespace(json, end);
+      if (pos >= json.size())
+         return false;
+      if (json[pos] == ']')
+         return true;
+      if (json[pos] != ',')
+         return false;
+      pos = skip_json_whitespace(json, pos + 1);
+   }
+   return false;
+}
+
+// Returns the raw text of a top level member of a JSON object, or an empty string if there is none
+std::string find_json_member(const std::string &json, const std::string &name) {
+   size_t pos = skip_json_whitespace(json, 0);
+   if (pos >= json.size() || json[pos] != '{')
+      return "";
+
+   pos = skip_json_whitespace(json, pos + 1);
+   while (pos < json.size() && json[pos] == '"') {
+      const size_t key_end = skip_json_value(json, pos);
+      if (key_end == std::string::npos)
+         return "";
+      const std::string key = json.substr(pos + 1, key_end - pos - 2);
+
+      pos = skip_json_whitespace(json, key_end);
+      if (pos >= json.size() || json[pos] != ':')
+         return "";
+
+      const size_t value_begin = skip_json_whitespace(json, pos + 1);
+      const size_t value_end = skip_json_value(json, value_begin);
+      if (value_end == std::string::npos)
+         return "";
+      if (key == name)
+         return json.substr(value_begin, value_end - value_begin);
+
+      pos = skip_json_whitespace(json, value_end);
+      if (pos >= json.size() || json[pos] != ',')
+         return "";
+      pos = skip_json_whitespace(json, pos + 1);
+   }
+   return "";
+}
+
+bool is_non_empty_json_container(const std::string &value) {
+   if (value.empty() || (value[0] != '{' && value[0] != '['))
+      return false;
+   const size_t pos = skip_json_whitespace(value, 1);
+   return pos < value.size() && value[pos] != '}' && value[pos] != ']';
+}
+
+std::string make_request_body(uint32_t id, const std::string &method, const std::string &params) {
+   std::stringstream body;
+
+   body << "{ \"jsonrpc\": \"2.0\", \"id\": " << id << ", \"method\": \"" << method << "\"";
+
+   if (!params.empty()) {
+      body << ", \"params\": " << params;
+   }
+
+   body << " }";
+
+   return body.str();
+}
+
+} // namespace
+
 class rpc_connection {
 public:
    rpc_connection(const rpc_credentials &_credentials, bool _debug_rpc_calls);
+   ~rpc_connection();
 
    std::string send_post_request(std::string method, std::string params, bool show_log);
+   std::vector<std::string> send_batch_post_request(const std::vector<rpc_call> &calls, bool show_log);
    std::string get_url() const;
 
 protected:
@@ -45,16 +193,33 @@ protected:
 private:
    rpc_reply send_post_request(std::string body, bool show_log);
 
+   bool is_connected() const;
+   void connect();
+   void disconnect();
+   void save_ssl_session();
+
    boost::beast::net::io_context ioc;
    boost::beast::net::ip::tcp::resolver resolver;
    boost::asio::ip::basic_resolver_results<boost::asio::ip::tcp> results;
+
+   // The connection is kept open between requests (HTTP/1.1 keep-alive), and the
+   // TLS session of the last connection is offered again when reconnecting
+   boost::asio::ssl::context ssl_ctx;
+   std::unique_ptr<boost::beast::net::ssl::stream<boost::beast::tcp_stream>> ssl_tcp_stream;
+   std::unique_ptr<boost::beast::tcp_stream> tcp_stream;
+   SSL_SESSION *ssl_session;
+
+   // This buffer is used for reading and must be persisted
+   boost::beast::flat_buffer buffer;
 };
 
 rpc_connection::rpc_connection(const rpc_credentials &_credentials, bool _debug_rpc_calls) :
       credentials(_credentials),
       debug_rpc_calls(_debug_rpc_calls),
       request_id(0),
-      resolver(ioc) {
+      resolver(ioc),
+      ssl_ctx(boost::asio::ssl::context::tlsv12_client),
+      ssl_session(nullptr) {
 
    std::string reg_expr = "^((?P<Protocol>https|http):\\/\\/)?(?P<Host>[a-zA-Z0-9\\-\\.]+)(:(?P<Port>\\d{1,5}))?(?P<Target>\\/.+)?";
    boost::xpressive::sregex sr = boost::xpressive::sregex::compile(reg_expr);
@@ -84,6 +249,11 @@ rpc_connection::rpc_connection(const rpc_credentials &_credentials, bool _debug_
 
       authorization = "Basic " + base64_encode(credentials.user + ":" + credentials.password);
 
+      if (protocol == "https") {
+         ssl_ctx.set_default_verify_paths();
+         ssl_ctx.set_verify_mode(boost::asio::ssl::verify_peer);
+      }
+
       results = resolver.resolve(host, port);
 
    } else {
@@ -91,6 +261,13 @@ rpc_connection::rpc_connection(const rpc_credentials &_credentials, bool _debug_
    }
 }
 
+rpc_connection::~rpc_connection() {
+   disconnect();
+   if (ssl_session) {
+      SSL_SESSION_free(ssl_session);
+   }
+}
+
 std::string rpc_connection::get_url() const {
    return credentials.url;
 }
@@ -160,36 +337,24 @@ std::string rpc_client::retrieve_value_from_reply(std::string reply_str, std::st
 }
 
 std::string rpc_connection::send_post_request(std::string method, std::string params, bool show_log) {
-   std::stringstream body;
-
    request_id = request_id + 1;
 
-   body << "{ \"jsonrpc\": \"2.0\", \"id\": " << request_id << ", \"method\": \"" << method << "\"";
-
-   if (!params.empty()) {
-      body << ", \"params\": " << params;
-   }
-
-   body << " }";
+   const std::string body = make_request_body(request_id, method, params);
 
    try {
-      const auto reply = send_post_request(body.str(), show_log);
+      const auto reply = send_post_request(body, show_log);
 
       if (reply.body.empty()) {
          wlog("RPC call ${function} failed", ("function", __FUNCTION__));
          return "";
       }
 
-      std::stringstream ss(std::string(reply.body.begin(), reply.body.end()));
-      boost::property_tree::ptree json;
-      boost::property_tree::read_json(ss, json);
-
-      if (json.count("error") && !json.get_child("error").empty()) {
-         wlog("RPC call ${function} with body ${body} failed with reply '${msg}'", ("function", __FUNCTION__)("body", body.str())("msg", ss.str()));
+      if (is_non_empty_json_container(find_json_member(reply.body, "error"))) {
+         wlog("RPC call ${function} with body ${body} failed with reply '${msg}'", ("function", __FUNCTION__)("body", body)("msg", reply.body));
       }
 
       if (reply.status == 200) {
-         return ss.str();
+         return reply.body;
       }
    } catch (const boost::system::system_error &e) {
       elog("RPC call ${function} failed: ${e}", ("function", __FUNCTION__)("e", e.what()));
@@ -198,33 +363,136 @@ std::string rpc_connection::send_post_request(std::string method, std::string pa
    return "";
 }
 
-rpc_reply rpc_connection::send_post_request(std::string body, bool show_log) {
+std::vector<std::string> rpc_connection::send_batch_post_request(const std::vector<rpc_call> &calls, bool show_log) {
+   std::vector<std::string> replies(calls.size());
+   if (calls.empty()) {
+      return replies;
+   }
+
+   const uint32_t first_request_id = request_id + 1;
+
+   std::stringstream body;
+   body << "[ ";
+   for (size_t i = 0; i < calls.size(); i++) {
+      request_id = request_id + 1;
+      body << (i ? ", " : "") << make_request_body(request_id, calls[i].method, calls[i].params);
+   }
+   body << " ]";
+
+   std::string reply_body;
+   try {
+      reply_body = send_post_request(body.str(), show_log).body;
+   } catch (const boost::system::system_error &e) {
+      elog("RPC call ${function} failed: ${e}", ("function", __FUNCTION__)("e", e.what()));
+   }
+
+   std::vector<std::string> elements;
+   if (reply_body.empty() || !split_json_array(reply_body, elements)) {
+      // Nodes without batch support reply with a single error object, and a batch reply may also be
+      // too large or lost on the way, so fall back to one call at a time
+      wlog("RPC call ${function} with ${n} calls failed with reply '${msg}', sending calls one by one", ("function", __FUNCTION__)("n", calls.size())("msg", reply_body));
+      for (size_t i = 0; i < calls.size(); i++) {
+         replies[i] = send_post_request(calls[i].method, calls[i].params, show_log);
+      }
+      return replies;
+   }
+
+   // Batch replies may come in any order, match them back to the calls by their id
+   for (const auto &element : elements) {
+      const std::string id = find_json_member(element, "id");
+      const uint64_t reply_id = std::strtoull(id.c_str(), nullptr, 10);
+      if (id.empty() || reply_id < first_request_id || reply_id >= first_request_id + calls.size()) {
+         wlog("RPC call ${function} got reply '${msg}' not matching any call", ("function", __FUNCTION__)("msg", element));
+         continue;
+      }
+
+      if (is_non_empty_json_container(find_json_member(element, "error"))) {
+         wlog("RPC call ${function} with method ${method} failed with reply '${msg}'", ("function", __FUNCTION__)("method", calls[reply_id - first_request_id].method)("msg", element));
+      }
 
-   // These object is used as a context for ssl connection
-   boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+      replies[reply_id - first_request_id] = element;
+   }
 
-   boost::beast::net::ssl::stream<boost::beast::tcp_stream> ssl_tcp_stream(ioc, ctx);
-   boost::beast::tcp_stream tcp_stream(ioc);
+   return replies;
+}
+
+bool rpc_connection::is_connected() const {
+   return ssl_tcp_stream || tcp_stream;
+}
+
+void rpc_connection::connect() {
+   buffer.clear();
 
-   // Set SNI Hostname (many hosts need this to handshake successfully)
    if (protocol == "https") {
-      if (!SSL_set_tlsext_host_name(ssl_tcp_stream.native_handle(), host.c_str())) {
+      ssl_tcp_stream.reset(new boost::beast::net::ssl::stream<boost::beast::tcp_stream>(ioc, ssl_ctx));
+
+      // Set SNI Hostname (many hosts need this to handshake successfully)
+      if (!SSL_set_tlsext_host_name(ssl_tcp_stream->native_handle(), host.c_str())) {
          boost::beast::error_code ec{static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()};
+         ssl_tcp_stream.reset();
          throw boost::beast::system_error{ec};
       }
-      ctx.set_default_verify_paths();
-      ctx.set_verify_mode(boost::asio::ssl::verify_peer);
-   }
 
-   // Make the connection on the IP address we get from a lookup
-   if (protocol == "https") {
-      boost::beast::get_lowest_layer(ssl_tcp_stream).connect(results);
-      ssl_tcp_stream.handshake(boost::beast::net::ssl::stream_base::client);
+      // Resume the previous session to skip the full handshake
+      if (ssl_session) {
+         SSL_set_session(ssl_tcp_stream->native_handle(), ssl_session);
+      }
+
+      try {
+         // Make the connection on the IP address we get from a lookup
+         boost::beast::get_lowest_layer(*ssl_tcp_stream).connect(results);
+         ssl_tcp_stream->handshake(boost::beast::net::ssl::stream_base::client);
+      } catch (const boost::system::system_error &) {
+         ssl_tcp_stream.reset();
+         throw;
+      }
+
+      save_ssl_session();
    } else {
-      tcp_stream.connect(results);
+      tcp_stream.reset(new boost::beast::tcp_stream(ioc));
+
+      try {
+         // Make the connection on the IP address we get from a lookup
+         tcp_stream->connect(results);
+      } catch (const boost::system::system_error &) {
+         tcp_stream.reset();
+         throw;
+      }
+   }
+}
+
+void rpc_connection::disconnect() {
+   // Errors are not reported here, the server may have already closed the connection.
+   // Also on ssl level some servers are managing connection close, so a TLS shutdown
+   // would sometimes end up with error stream truncated
+   boost::beast::error_code ec;
+   if (ssl_tcp_stream) {
+      // TLS 1.3 servers send session tickets after the handshake, so take the latest one
+      save_ssl_session();
+      boost::beast::get_lowest_layer(*ssl_tcp_stream).socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      boost::beast::get_lowest_layer(*ssl_tcp_stream).socket().close(ec);
+      ssl_tcp_stream.reset();
+   }
+   if (tcp_stream) {
+      tcp_stream->socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      tcp_stream->socket().close(ec);
+      tcp_stream.reset();
    }
+}
+
+void rpc_connection::save_ssl_session() {
+   SSL_SESSION *session = SSL_get1_session(ssl_tcp_stream->native_handle());
+   if (session) {
+      if (ssl_session) {
+         SSL_SESSION_free(ssl_session);
+      }
+      ssl_session = session;
+   }
+}
+
+rpc_reply rpc_connection::send_post_request(std::string body, bool show_log) {
 
-   // Set up an HTTP GET request message
+   // Set up an HTTP POST request message
    boost::beast::http::request<boost::beast::http::string_body> req{boost::beast::http::verb::post, target, 11};
    req.set(boost::beast::http::field::host, host + ":" + port);
    req.set(boost::beast::http::field::accept, "application/json");
@@ -232,42 +500,56 @@ rpc_reply rpc_connection::send_post_request(std::string body, bool show_log) {
    req.set(boost::beast::http::field::content_type, "application/json");
    req.set(boost::beast::http::field::content_encoding, "utf-8");
    req.set(boost::beast::http::field::content_length, body.length());
+   req.keep_alive(true);
    req.body() = body;
 
-   // Send the HTTP request to the remote host
-   if (protocol == "https")
-      boost::beast::http::write(ssl_tcp_stream, req);
-   else
-      boost::beast::http::write(tcp_stream, req);
+   std::string rbody;
+   bool keep_alive = false;
 
-   // This buffer is used for reading and must be persisted
-   boost::beast::flat_buffer buffer;
-
-   // Declare a container to hold the response
-   boost::beast::http::response<boost::beast::http::dynamic_body> res;
-
-   // Receive the HTTP response
-   if (protocol == "https")
-      boost::beast::http::read(ssl_tcp_stream, buffer, res);
-   else
-      boost::beast::http::read(tcp_stream, buffer, res);
+   // The server may have closed a kept-alive connection since the last request,
+   // so a request failing on a reused connection is retried once on a new one
+   for (bool reused = is_connected();; reused = false) {
+      bool request_written = false;
+      try {
+         if (!is_connected()) {
+            connect();
+         }
 
-   // Gracefully close the socket
-   boost::beast::error_code ec;
-   if (protocol == "https") {
-      boost::beast::get_lowest_layer(ssl_tcp_stream).close();
-   } else {
-      tcp_stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+         // Send the HTTP request to the remote host
+         if (protocol == "https")
+            boost::beast::http::write(*ssl_tcp_stream, req);
+         else
+            boost::beast::http::write(*tcp_stream, req);
+         request_written = true;
+
+         // Receive the HTTP response
+         boost::beast::http::response_parser<boost::beast::http::dynamic_body> parser;
+         parser.body_limit(max_response_body_size);
+         if (protocol == "https")
+            boost::beast::http::read(*ssl_tcp_stream, buffer, parser);
+         else
+            boost::beast::http::read(*tcp_stream, buffer, parser);
+
+         const auto &res = parser.get();
+         rbody = std::string{boost::asio::buffers_begin(res.body().data()),
+                             boost::asio::buffers_end(res.body().data())};
+         keep_alive = res.keep_alive();
+         break;
+      } catch (const boost::system::system_error &e) {
+         disconnect();
+         // Once written, the request may have been processed, so it is only sent again
+         // if the connection was closed before any of the response arrived
+         const bool closed_before_response = (e.code() == boost::beast::http::error::end_of_stream);
+         if (!reused || (request_written && !closed_before_response)) {
+            throw;
+         }
+      }
    }
 
-   // not_connected happens sometimes. Also on ssl level some servers are managing
-   // connecntion close, so closing here will sometimes end up with error stream truncated
-   // so don't bother reporting it.
-   if (ec && ec != boost::beast::errc::not_connected && ec != boost::asio::ssl::error::stream_truncated)
-      throw boost::beast::system_error{ec};
+   if (!keep_alive) {
+      disconnect();
+   }
 
-   std::string rbody{boost::asio::buffers_begin(res.body().data()),
-                     boost::asio::buffers_end(res.body().data())};
    rpc_reply reply;
    reply.status = 200;
    reply.body = rbody;
@@ -379,6 +661,11 @@ std::string rpc_client::send_post_request(rpc_connection &conn, std::string meth
    return conn.send_post_request(method, params, show_log);
 }
 
+std::vector<std::string> rpc_client::send_batch_post_request(const std::vector<rpc_call> &calls, bool show_log) {
+   const std::lock_guard<std::mutex> lock(conn_mutex);
+   return get_active_connection().send_batch_post_request(calls, show_log);
+}
+
 rpc_client::~rpc_client() {
    try {
       if (connection_selection_task.valid())
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <fc/thread/future.hpp>
 #include <fc/thread/thread.hpp>
@@ -21,6 +22,11 @@ struct rpc_credentials {
    std::string password;
 };
 
+struct rpc_call {
+   std::string method;
+   std::string params;
+};
+
 class rpc_client {
 public:
    const sidechain_type sidechain;
@@ -35,6 +41,9 @@ protected:
 
    static std::string send_post_request(rpc_connection &conn, std::string method, std::string params, bool show_log);
 
+   //! Sends all calls as a single JSON-RPC batch, replies are returned in the order of the calls
+   std::vector<std::string> send_batch_post_request(const std::vector<rpc_call> &calls, bool show_log);
+
    static std::string retrieve_array_value_from_reply(std::string reply_str, std::string array_path, uint32_t idx);
    static std::string retrieve_value_from_reply(std::string reply_str, std::string value_path);
 
@@ -3,6 +3,7 @@
 #include <graphene/peerplays_sidechain/sidechain_net_handler.hpp>
 
 #include <string>
+#include <vector>
 
 #include <boost/bimap.hpp>
 #include <boost/signals2.hpp>
@@ -18,6 +19,7 @@ public:
 
    std::string eth_blockNumber();
    std::string eth_get_block_by_number(std::string block_number, bool full_block);
+   std::vector<std::string> eth_get_blocks_by_number(const std::vector<std::string> &block_numbers, bool full_block);
    std::string eth_get_logs(std::string wallet_contract_address);
    std::string eth_chainId();
    std::string net_version();
@@ -35,6 +37,7 @@ public:
    std::string eth_send_transaction(const std::string &params);
    std::string eth_send_raw_transaction(const std::string &params);
    std::string eth_get_transaction_receipt(const std::string &params);
+   std::vector<std::string> eth_get_transaction_receipts(const std::vector<std::string> &transaction_hashes);
    std::string eth_get_transaction_by_hash(const std::string &params);
 
    virtual uint64_t ping(rpc_connection &conn) const override;
@@ -78,6 +81,7 @@ private:
    void schedule_ethereum_listener();
    void ethereum_listener_loop();
    void handle_event(const std::string &block_number);
+   bool handle_block(const std::string &block_number, const std::string &block);
 };
 
 }} // namespace graphene::peerplays_sidechain
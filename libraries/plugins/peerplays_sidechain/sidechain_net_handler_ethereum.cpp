@@ -39,6 +39,15 @@ std::string ethereum_rpc_client::eth_get_block_by_number(std::string block_numbe
    return send_post_request("eth_getBlockByNumber", params, debug_rpc_calls);
 }
 
+std::vector<std::string> ethereum_rpc_client::eth_get_blocks_by_number(const std::vector<std::string> &block_numbers, bool full_block) {
+   std::vector<rpc_call> calls;
+   calls.reserve(block_numbers.size());
+   for (const auto &block_number : block_numbers) {
+      calls.push_back({"eth_getBlockByNumber", "[ \"" + block_number + "\", " + (full_block ? "true" : "false") + "]"});
+   }
+   return send_batch_post_request(calls, debug_rpc_calls);
+}
+
 std::string ethereum_rpc_client::eth_get_logs(std::string wallet_contract_address) {
    const std::string params = "[{\"address\": \"" + wallet_contract_address + "\"}]";
    const std::string reply_str = send_post_request("eth_getLogs", params, debug_rpc_calls);
@@ -122,6 +131,15 @@ std::string ethereum_rpc_client::eth_get_transaction_receipt(const std::string &
    return send_post_request("eth_getTransactionReceipt", "[\"" + params + "\"]", debug_rpc_calls);
 }
 
+std::vector<std::string> ethereum_rpc_client::eth_get_transaction_receipts(const std::vector<std::string> &transaction_hashes) {
+   std::vector<rpc_call> calls;
+   calls.reserve(transaction_hashes.size());
+   for (const auto &transaction_hash : transaction_hashes) {
+      calls.push_back({"eth_getTransactionReceipt", "[\"" + transaction_hash + "\"]"});
+   }
+   return send_batch_post_request(calls, debug_rpc_calls);
+}
+
 std::string ethereum_rpc_client::eth_get_transaction_by_hash(const std::string &params) {
    return send_post_request("eth_getTransactionByHash", "[\"" + params + "\"]", debug_rpc_calls);
 }
@@ -741,10 +759,13 @@ bool sidechain_net_handler_ethereum::settle_sidechain_transaction(const sidechai
       return false;
    }
 
-   size_t count = 0;
+   std::vector<std::string> transaction_hashes;
    for (const auto &entry : json.get_child("result_array")) {
-      const std::string receipt = rpc_client->eth_get_transaction_receipt(entry.second.get<std::string>("transaction_receipt"));
+      transaction_hashes.push_back(entry.second.get<std::string>("transaction_receipt"));
+   }
 
+   size_t count = 0;
+   for (const auto &receipt : rpc_client->eth_get_transaction_receipts(transaction_hashes)) {
       std::stringstream ss_receipt(receipt);
       boost::property_tree::ptree json_receipt;
       boost::property_tree::read_json(ss_receipt, json_receipt);
@@ -885,19 +906,36 @@ void sidechain_net_handler_ethereum::ethereum_listener_loop() {
             return;
          }
 
-         //! Send event data for all blocks that passed
-         for (uint64_t i = last_block_received + 1; i <= head_block_number; ++i) {
-            const std::string block_number = ethereum::add_0x(ethereum::to_hex(i, false));
-            handle_event(block_number);
-         }
+         //! Send event data for all blocks that passed, fetching them in batches.
+         //! Full blocks can take megabytes each, so batches are kept small
+         const uint64_t max_blocks_per_batch = 10;
+         for (uint64_t first = last_block_received + 1; first <= head_block_number; first += max_blocks_per_batch) {
+            const uint64_t last = std::min(head_block_number, first + max_blocks_per_batch - 1);
 
-         last_block_received = head_block_number;
+            std::vector<std::string> block_numbers;
+            for (uint64_t i = first; i <= last; ++i) {
+               block_numbers.push_back(ethereum::add_0x(ethereum::to_hex(i, false)));
+            }
+
+            const auto blocks = rpc_client->eth_get_blocks_by_number(block_numbers, true);
+            for (size_t i = 0; i < block_numbers.size(); ++i) {
+               //! Stop at the first block that could not be processed, it is fetched again next time
+               if (!handle_block(block_numbers[i], blocks[i])) {
+                  wlog("Could not process block ${block_number}, retrying later", ("block_number", block_numbers[i]));
+                  return;
+               }
+               last_block_received = first + i;
+            }
+         }
       }
    }
 }
 
 void sidechain_net_handler_ethereum::handle_event(const std::string &block_number) {
-   const std::string block = rpc_client->eth_get_block_by_number(block_number, true);
+   handle_block(block_number, rpc_client->eth_get_block_by_number(block_number, true));
+}
+
+bool sidechain_net_handler_ethereum::handle_block(const std::string &block_number, const std::string &block) {
    if (block != "") {
       add_to_son_listener_log("BLOCK   : " + block_number);
       std::stringstream ss(block);
@@ -906,7 +944,7 @@ void sidechain_net_handler_ethereum::handle_event(const std::string &block_numbe
 
       if (block_json.get<string>("result") == "null") {
          wlog("No data for block ${block_number}", ("block_number", block_number));
-         return;
+         return false;
       }
 
       size_t tx_idx = -1;
@@ -986,7 +1024,9 @@ void sidechain_net_handler_ethereum::handle_event(const std::string &block_numbe
             sidechain_event_data_received(sed);
          }
       }
+      return true;
    }
+   return false;
 }
 
 }} // namespace graphene::peerplays_sidechain
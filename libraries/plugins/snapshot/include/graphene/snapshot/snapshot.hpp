@@ -52,6 +52,7 @@ class snapshot_plugin : public graphene::app::plugin {
        uint32_t           snapshot_block = -1, last_block = 0;
        fc::time_point_sec snapshot_time = fc::time_point_sec::maximum(), last_time = fc::time_point_sec(1);
        fc::path           dest;
+       bool               binary_format = false;
 };
 
 } } //graphene::snapshot_plugin
@@ -36,6 +36,9 @@ namespace bpo = boost::program_options;
 static const char* OPT_BLOCK_NUM  = "snapshot-at-block";
 static const char* OPT_BLOCK_TIME = "snapshot-at-time";
 static const char* OPT_DEST       = "snapshot-to";
+static const char* OPT_FORMAT     = "snapshot-format";
+static const char* OPT_RESTORE    = "snapshot-restore";
+static const char* OPT_RESTORE_FORCE = "snapshot-restore-force";
 
 void snapshot_plugin::plugin_set_program_options(
    boost::program_options::options_description& command_line_options,
@@ -44,9 +47,19 @@ void snapshot_plugin::plugin_set_program_options(
    command_line_options.add_options()
          (OPT_BLOCK_NUM, bpo::value<uint32_t>(), "Block number after which to do a snapshot")
          (OPT_BLOCK_TIME, bpo::value<string>(), "Block time (ISO format) after which to do a snapshot")
-         (OPT_DEST, bpo::value<string>(), "Pathname of JSON file where to store the snapshot")
+         (OPT_DEST, bpo::value<string>(), "Pathname of file where to store the snapshot")
+         (OPT_FORMAT, bpo::value<string>()->default_value("json"),
+          "Snapshot format, 'json' for one object per line or 'binary' for a snapshot that can be restored with snapshot-restore")
          ;
    config_file_options.add(command_line_options);
+   // Restoring replaces the object database, so it is only accepted on the command line where it cannot be
+   // left behind to repeat on every start
+   command_line_options.add_options()
+         (OPT_RESTORE, bpo::value<string>(),
+          "Pathname of a binary snapshot to load the object database from at startup instead of replaying the blockchain")
+         (OPT_RESTORE_FORCE, bpo::bool_switch()->default_value(false),
+          "Allow snapshot-restore to replace an existing object database")
+         ;
 }
 
 std::string snapshot_plugin::plugin_name()const
@@ -71,12 +84,26 @@ void snapshot_plugin::plugin_initialize(const boost::program_options::variables_
          snapshot_block = options[OPT_BLOCK_NUM].as<uint32_t>();
       if( options.count(OPT_BLOCK_TIME) )
          snapshot_time = fc::time_point_sec::from_iso_string( options[OPT_BLOCK_TIME].as<std::string>() );
+      if( options.count(OPT_FORMAT) )
+      {
+         const auto& format = options[OPT_FORMAT].as<std::string>();
+         FC_ASSERT( format == "json" || format == "binary", "snapshot-format must be 'json' or 'binary'" );
+         binary_format = ( format == "binary" );
+      }
       database().applied_block.connect( [&]( const graphene::chain::signed_block& b ) {
          check_snapshot( b );
       });
    }
    else
       FC_ASSERT( !options.count("snapshot-to"), "Must specify snapshot-at-block or snapshot-at-time in addition to snapshot-to!" );
+
+   if( options.count(OPT_RESTORE) )
+   {
+      const fc::path snapshot = options[OPT_RESTORE].as<std::string>();
+      FC_ASSERT( fc::exists( snapshot ), "Snapshot to restore does not exist", ("snapshot",snapshot) );
+      ilog( "snapshot plugin: object database will be restored from ${s}", ("s",snapshot) );
+      database().set_snapshot_to_restore( snapshot, options[OPT_RESTORE_FORCE].as<bool>() );
+   }
    ilog("snapshot plugin: plugin_initialize() end");
 } FC_LOG_AND_RETHROW() }
 
@@ -117,12 +144,32 @@ static void create_snapshot( const graphene::chain::database& db, const fc::path
    ilog("snapshot plugin: created snapshot");
 }
 
+static void create_binary_snapshot( const graphene::chain::database& db, const fc::path& dest )
+{
+   ilog("snapshot plugin: creating binary snapshot");
+   try
+   {
+      db.save_snapshot( dest );
+   }
+   catch ( fc::exception& e )
+   {
+      wlog( "Failed to write binary snapshot: ${ex}", ("ex",e) );
+      return;
+   }
+   ilog("snapshot plugin: created binary snapshot");
+}
+
 void snapshot_plugin::check_snapshot( const graphene::chain::signed_block& b )
 { try {
     uint32_t current_block = b.block_num();
     if( (last_block < snapshot_block && snapshot_block <= current_block)
            || (last_time < snapshot_time && snapshot_time <= b.timestamp) )
-       create_snapshot( database(), dest );
+    {
+       if( binary_format )
+          create_binary_snapshot( database(), dest );
+       else
+          create_snapshot( database(), dest );
+    }
     last_block = current_block;
     last_time = b.timestamp;
 } FC_LOG_AND_RETHROW() }
@@ -24,9 +24,17 @@
 #include <graphene/utilities/elasticsearch.hpp>
 
 #include <boost/algorithm/string/join.hpp>
+#include <boost/filesystem.hpp>
 #include <fc/log/logger.hpp>
 #include <fc/io/json.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
 size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp)
 {
    ((std::string*)userp)->append((char*)contents, size * nmemb);
@@ -201,8 +209,309 @@ const std::string doCurl(CurlRequest& curl)
    if(!curl.auth.empty())
       curl_easy_setopt(curl.handler, CURLOPT_USERPWD, curl.auth.c_str());
    curl_easy_perform(curl.handler);
+   curl_easy_setopt(curl.handler, CURLOPT_HTTPHEADER, NULL);
+   curl_slist_free_all(headers);
 
    return CurlReadBuffer;
 }
 
+BulkExporter::BulkExporter(const Config& config)
+   : _config(config), _queue(std::max<uint32_t>(config.queue_size, 1))
+{
+   if(!_config.spool_dir.empty())
+   {
+      boost::filesystem::create_directories(_config.spool_dir);
+      // continue numbering after, and resend, whatever a previous run left behind
+      for(const auto& file : spooledFiles())
+      {
+         try {
+            const uint64_t seq = std::stoull(boost::filesystem::path(file).stem().string());
+            _next_spool_file = std::max<uint64_t>(_next_spool_file, seq + 1);
+         } catch(const std::exception&) {
+            wlog("Unexpected file ${f} in the Elastic Search spool directory", ("f",file));
+         }
+         ++_spooled_on_disk;
+      }
+   }
+   _thread = std::thread([this]() { run(); });
+}
+
+BulkExporter::~BulkExporter()
+{
+   _stopping = true;
+   _work_available.notify_one();
+   if(_thread.joinable())
+      _thread.join();
+   std::vector<std::string>* batch = nullptr;
+   while(_queue.pop(batch))
+      delete batch;
+}
+
+bool BulkExporter::enqueue(std::vector<std::string>&& lines)
+{
+   if(lines.empty())
+      return true;
+   // there is a single producer, so room seen here is still there when pushing
+   if(_queue.write_available() == 0)
+   {
+      ++_queue_full;
+      return false;
+   }
+   const auto count = lines.size();
+   _queue.push(new std::vector<std::string>(std::move(lines)));
+   lines.clear();
+   _queued_lines += count;
+   _work_available.notify_one();
+   return true;
+}
+
+void BulkExporter::flush()
+{
+   _flush_requested = true;
+   _work_available.notify_one();
+}
+
+BulkExporter::Stats BulkExporter::getStats()const
+{
+   Stats stats;
+   stats.queued_lines = _queued_lines;
+   stats.sent_lines = _sent_lines;
+   stats.sent_requests = _sent_requests;
+   stats.failed_requests = _failed_requests;
+   stats.rejected_batches = _rejected_batches;
+   stats.dropped_batches = _dropped_batches;
+   stats.spooled_batches = _spooled_batches;
+   stats.queue_full = _queue_full;
+   return stats;
+}
+
+void BulkExporter::run()
+{
+   typedef std::chrono::steady_clock clock;
+   const auto flush_interval = std::chrono::milliseconds(_config.flush_interval_ms);
+   const auto stats_interval = std::chrono::seconds(60);
+   const auto spool_retry_interval = std::chrono::seconds(5);
+
+   // reusing one handle lets libcurl keep the HTTP connection open between bulk requests; TCP keepalive probes
+   // additionally stop an idle connection from being silently dropped between quiet periods
+   _curl = curl_easy_init();
+   curl_easy_setopt(_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+   curl_easy_setopt(_curl, CURLOPT_ACCEPT_ENCODING, "");
+
+   std::vector<std::string> pending;
+   auto first_pending = clock::now();
+   auto last_stats = clock::now();
+   auto last_spool_retry = clock::now();
+   if(_spooled_on_disk > 0)
+      resendSpooled();
+
+   while(true)
+   {
+      std::vector<std::string>* batch = nullptr;
+      while(pending.size() < _config.batch_size && _queue.pop(batch))
+      {
+         if(pending.empty())
+            first_pending = clock::now();
+         std::move(batch->begin(), batch->end(), std::back_inserter(pending));
+         delete batch;
+      }
+
+      const bool stopping = _stopping;
+      if(pending.empty())
+      {
+         _flush_requested = false;
+         if(stopping && _queue.empty())
+            break;
+      }
+      else if(stopping || pending.size() >= _config.batch_size || _flush_requested.exchange(false)
+              || clock::now() - first_pending >= flush_interval)
+      {
+         const auto lines = pending.size();
+         sendWithRetry(joinBulkLines(pending));
+         _sent_lines += lines;
+         pending.clear();
+         continue;
+      }
+
+      if(_spooled_on_disk > 0 && clock::now() - last_spool_retry >= spool_retry_interval)
+      {
+         last_spool_retry = clock::now();
+         resendSpooled();
+      }
+
+      if(clock::now() - last_stats >= stats_interval)
+      {
+         last_stats = clock::now();
+         const auto stats = getStats();
+         ilog("Elastic Search export: ${q} lines queued, ${s} sent in ${r} requests, ${f} failed requests, "
+              "${j} batches rejected, ${d} dropped, ${p} spooled, queue full ${w} times",
+              ("q",stats.queued_lines)("s",stats.sent_lines)("r",stats.sent_requests)("f",stats.failed_requests)
+              ("j",stats.rejected_batches)("d",stats.dropped_batches)("p",stats.spooled_batches)
+              ("w",stats.queue_full));
+      }
+
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_available.wait_for(lock, std::min<std::chrono::milliseconds>(flush_interval, std::chrono::milliseconds(100)));
+   }
+
+   curl_easy_cleanup(_curl);
+   _curl = nullptr;
+}
+
+void BulkExporter::sendWithRetry(const std::string& body)
+{
+   // spooled batches are older, they have to be indexed first so that documents are not overwritten by stale ones
+   if(_spooled_on_disk > 0)
+   {
+      resendSpooled();
+      if(_spooled_on_disk > 0)
+      {
+         spool(body);
+         return;
+      }
+   }
+
+   // with a spool directory the batch goes to disk after a few attempts; without one it is retried until ES is
+   // back, the queue fills up meanwhile and block processing fails and is retried, so nothing is lost
+   static const uint32_t max_attempts = 5;
+   static const uint32_t max_backoff_ms = 30000;
+   uint32_t backoff_ms = 100;
+   for(uint32_t attempt = 1; ; ++attempt)
+   {
+      const auto result = send(body);
+      if(result == SendResult::sent)
+         return;
+      if(result == SendResult::rejected)
+      {
+         reject(body);
+         return;
+      }
+      if(attempt >= max_attempts && !_config.spool_dir.empty())
+      {
+         spool(body);
+         return;
+      }
+      if(_stopping)
+         break;
+      if(attempt == max_attempts)
+         elog("Elastic Search is unreachable, holding back the export until it is up again");
+      std::unique_lock<std::mutex> lock(_mutex);
+      _work_available.wait_for(lock, std::chrono::milliseconds(backoff_ms), [this]() { return _stopping.load(); });
+      backoff_ms = std::min(backoff_ms * 2, max_backoff_ms);
+   }
+
+   // shutting down while ES is unreachable, there is nowhere left to keep the batch
+   ++_dropped_batches;
+   elog("Elastic Search is unreachable at shutdown and no spool directory is set, dropping a bulk request of ${n} bytes",
+        ("n",body.size()));
+}
+
+BulkExporter::SendResult BulkExporter::send(const std::string& body)
+{
+   CurlRequest curl_request;
+   curl_request.handler = _curl;
+   curl_request.url = _config.elasticsearch_url + "_bulk";
+   curl_request.auth = _config.auth;
+   curl_request.type = "POST";
+   curl_request.query = body;
+
+   const auto response = doCurl(curl_request);
+   const long http_code = getResponseCode(_curl);
+   try {
+      if(handleBulkResponse(http_code, response))
+      {
+         ++_sent_requests;
+         return SendResult::sent;
+      }
+   } catch(const fc::exception& e) {
+      elog("Invalid bulk response from Elastic Search: ${e}", ("e",e.to_detail_string()));
+      ++_failed_requests;
+      return SendResult::failed;
+   }
+   ++_failed_requests;
+
+   // a 200 reply here reports item errors; those, like client errors, come back the same when resent.
+   // 408 and 429 only ask to try again later
+   if(http_code == 200 || (http_code >= 400 && http_code < 500 && http_code != 408 && http_code != 429))
+   {
+      if(http_code == 200)
+         elog("Elastic Search rejected items of a bulk request: ${r}", ("r",response.substr(0, 1000)));
+      return SendResult::rejected;
+   }
+   return SendResult::failed;
+}
+
+void BulkExporter::spool(const std::string& body)
+{
+   char name[32];
+   std::snprintf(name, sizeof(name), "%020llu.bulk", (unsigned long long)_next_spool_file++);
+   const std::string file = (boost::filesystem::path(_config.spool_dir) / name).string();
+   std::ofstream out(file, std::ios::out | std::ios::binary | std::ios::trunc);
+   out.write(body.data(), body.size());
+   out.close();
+   if(!out)
+   {
+      elog("Unable to spool bulk data to ${f}", ("f",file));
+      return;
+   }
+   ++_spooled_batches;
+   ++_spooled_on_disk;
+}
+
+void BulkExporter::reject(const std::string& body)
+{
+   ++_rejected_batches;
+   if(_config.spool_dir.empty())
+   {
+      elog("Dropping a bulk request of ${n} bytes rejected by Elastic Search", ("n",body.size()));
+      return;
+   }
+
+   const boost::filesystem::path dir = boost::filesystem::path(_config.spool_dir) / "rejected";
+   boost::system::error_code ec;
+   boost::filesystem::create_directories(dir, ec);
+   char name[48];
+   std::snprintf(name, sizeof(name), "%020llu-%020llu.bulk", (unsigned long long)std::time(nullptr),
+                 (unsigned long long)_next_rejected_file++);
+   const std::string file = (dir / name).string();
+   std::ofstream out(file, std::ios::out | std::ios::binary | std::ios::trunc);
+   out.write(body.data(), body.size());
+   out.close();
+   if(!out)
+      elog("Unable to save a bulk request of ${n} bytes rejected by Elastic Search to ${f}",
+           ("n",body.size())("f",file));
+   else
+      elog("Bulk request rejected by Elastic Search saved to ${f}", ("f",file));
+}
+
+std::vector<std::string> BulkExporter::spooledFiles()const
+{
+   std::vector<std::string> files;
+   for(boost::filesystem::directory_iterator itr(_config.spool_dir); itr != boost::filesystem::directory_iterator(); ++itr)
+      if(itr->path().extension() == ".bulk")
+         files.push_back(itr->path().string());
+   // file names are zero padded sequence numbers, so this restores the original order
+   std::sort(files.begin(), files.end());
+   return files;
+}
+
+void BulkExporter::resendSpooled()
+{
+   for(const auto& file : spooledFiles())
+   {
+      std::ifstream in(file, std::ios::in | std::ios::binary);
+      const std::string body((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      in.close();
+      const auto result = send(body);
+      if(result == SendResult::failed)
+         return;
+      // a rejected batch would be rejected again, it must not hold back the ones behind it
+      if(result == SendResult::rejected)
+         reject(body);
+      boost::filesystem::remove(file);
+      if(_spooled_on_disk > 0)
+         --_spooled_on_disk;
+   }
+}
+
 } } // end namespace graphene::utilities
@@ -22,10 +22,16 @@
  * THE SOFTWARE.
  */
 #pragma once
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <boost/lockfree/spsc_queue.hpp>
+
 #include <curl/curl.h>
 #include <fc/time.hpp>
 #include <fc/variant_object.hpp>
@@ -53,6 +59,84 @@ namespace graphene { namespace utilities {
          std::string query;
    };
 
+   /**
+    *  Sends bulk lines to Elastic Search from a dedicated thread so that block processing never waits on the
+    *  network.  Lines are handed over through a bounded single producer queue and merged into requests of up to
+    *  batch_size lines.  Requests which fail are retried with exponential backoff; when a spool directory is
+    *  set, batches that keep failing are written there and sent, in order, once ES is back, otherwise they are
+    *  retried until ES is back while the queue fills up and the producer is told to retry.  Requests rejected
+    *  by ES (4xx replies or item errors in the bulk reply) are never retried, they are logged and moved to the
+    *  rejected/ subdirectory of the spool directory, if any.
+    *  A full queue is reported to the producer instead of blocking it.
+    */
+   class BulkExporter {
+      public:
+         struct Config {
+            std::string elasticsearch_url;
+            std::string auth;
+            uint32_t    batch_size = 10000;        ///< maximum number of lines per bulk request
+            uint32_t    flush_interval_ms = 1000;  ///< maximum time lines are held before being sent
+            uint32_t    queue_size = 64;           ///< number of batches buffered in memory
+            std::string spool_dir;                 ///< directory for batches that could not be sent, empty to disable
+         };
+         struct Stats {
+            uint64_t queued_lines = 0;
+            uint64_t sent_lines = 0;
+            uint64_t sent_requests = 0;
+            uint64_t failed_requests = 0;
+            uint64_t rejected_batches = 0;         ///< batches ES refused, which are not retried
+            uint64_t dropped_batches = 0;          ///< batches lost at shutdown while ES was down, without a spool directory
+            uint64_t spooled_batches = 0;
+            uint64_t queue_full = 0;               ///< times lines were refused because the queue was full
+         };
+
+         explicit BulkExporter(const Config& config);
+         /** Sends everything still queued, then stops the exporter thread */
+         ~BulkExporter();
+
+         /**
+          *  Queues lines for export, never performs network I/O and never waits
+          *  @return false if the queue is full, in which case @p lines are left untouched
+          */
+         bool enqueue(std::vector<std::string>&& lines);
+         /** Sends the lines queued so far without waiting for a full batch or the flush interval */
+         void flush();
+         Stats getStats()const;
+
+      private:
+         enum class SendResult { sent, rejected, failed };
+
+         void run();
+         void sendWithRetry(const std::string& body);
+         SendResult send(const std::string& body);
+         void spool(const std::string& body);
+         void reject(const std::string& body);
+         std::vector<std::string> spooledFiles()const;
+         void resendSpooled();
+
+         const Config _config;
+         boost::lockfree::spsc_queue<std::vector<std::string>*> _queue;
+         std::mutex _mutex;
+         std::condition_variable _work_available;
+         std::atomic<bool> _flush_requested{false};
+         std::atomic<bool> _stopping{false};
+         std::atomic<uint64_t> _next_spool_file{0};
+         std::atomic<uint64_t> _spooled_on_disk{0};
+         CURL* _curl = nullptr;
+
+         std::atomic<uint64_t> _queued_lines{0};
+         std::atomic<uint64_t> _sent_lines{0};
+         std::atomic<uint64_t> _sent_requests{0};
+         std::atomic<uint64_t> _failed_requests{0};
+         std::atomic<uint64_t> _rejected_batches{0};
+         std::atomic<uint64_t> _dropped_batches{0};
+         std::atomic<uint64_t> _spooled_batches{0};
+         std::atomic<uint64_t> _queue_full{0};
+         std::atomic<uint64_t> _next_rejected_file{0};
+
+         std::thread _thread;
+   };
+
    bool SendBulk(ES& es);
    const std::vector<std::string> createBulk(const fc::mutable_variant_object& bulk_header, const std::string&& data);
    bool checkES(ES& es);
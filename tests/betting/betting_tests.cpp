@@ -307,6 +307,108 @@ BOOST_AUTO_TEST_CASE(binned_order_books)
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(order_book_price_levels)
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+      CREATE_ICE_HOCKEY_BETTING_MARKET(false, 0);
+
+      transfer(account_id_type(), alice_id, asset(10000));
+      transfer(account_id_type(), bob_id, asset(10000));
+
+      const auto& order_books = db.get_index_type< primary_index< bet_object_index > >().get_secondary_index< bet_order_book_index >();
+      BOOST_CHECK(order_books.get_order_book(capitals_win_market_id) == nullptr);
+
+      // two back bets share the 1.6 level, one more sits at 1.7
+      place_bet(bob_id, capitals_win_market_id, bet_type::back, asset(100, asset_id_type()), 16 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+      place_bet(bob_id, capitals_win_market_id, bet_type::back, asset(200, asset_id_type()), 16 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+      place_bet(bob_id, capitals_win_market_id, bet_type::back, asset(100, asset_id_type()), 17 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+
+      const bet_order_book_index::order_book* book = order_books.get_order_book(capitals_win_market_id);
+      BOOST_REQUIRE(book != nullptr);
+      BOOST_REQUIRE_EQUAL(book->back_levels.size(), 2u);
+      BOOST_CHECK(book->lay_levels.empty());
+      BOOST_CHECK_EQUAL(book->back_levels.begin()->first, 16 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+      BOOST_CHECK_EQUAL(book->back_levels.begin()->second.amount_to_bet.value, 300);
+      BOOST_CHECK_EQUAL(book->back_levels.begin()->second.bet_count, 2u);
+      BOOST_CHECK_EQUAL(book->back_levels.rbegin()->second.amount_to_bet.value, 100);
+
+      // a lay at 1.5 doesn't reach the best back level, so it rests on the book
+      bet_object lay_at_one_point_five;
+      lay_at_one_point_five.betting_market_id = capitals_win_market_id;
+      lay_at_one_point_five.back_or_lay = bet_type::lay;
+      lay_at_one_point_five.backer_multiplier = 15 * GRAPHENE_BETTING_ODDS_PRECISION / 10;
+      BOOST_CHECK(!order_books.has_matching_bets(lay_at_one_point_five));
+      place_bet(alice_id, capitals_win_market_id, bet_type::lay, asset(50, asset_id_type()), 15 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+      book = order_books.get_order_book(capitals_win_market_id);
+      BOOST_REQUIRE(book != nullptr);
+      BOOST_REQUIRE_EQUAL(book->lay_levels.size(), 1u);
+      BOOST_CHECK_EQUAL(book->lay_levels.begin()->second.amount_to_bet.value, 50);
+
+      // a lay at 1.6 matching 100 consumes the oldest bet at the 1.6 level first
+      place_bet(alice_id, capitals_win_market_id, bet_type::lay, asset(60, asset_id_type()), 16 * GRAPHENE_BETTING_ODDS_PRECISION / 10);
+      book = order_books.get_order_book(capitals_win_market_id);
+      BOOST_REQUIRE(book != nullptr);
+      BOOST_REQUIRE_EQUAL(book->back_levels.size(), 2u);
+      BOOST_CHECK_EQUAL(book->back_levels.begin()->second.amount_to_bet.value, 200);
+      BOOST_CHECK_EQUAL(book->back_levels.begin()->second.bet_count, 1u);
+      BOOST_REQUIRE_EQUAL(book->lay_levels.size(), 1u);
+
+      // the binned book is built from the levels
+      graphene::bookie::bookie_api bookie_api(app);
+      graphene::bookie::binned_order_book binned_orders = bookie_api.get_binned_order_book(capitals_win_market_id, 1);
+      BOOST_REQUIRE_EQUAL(binned_orders.aggregated_back_bets.size(), 2u);
+      BOOST_CHECK_EQUAL(binned_orders.aggregated_back_bets[0].amount_to_bet.value, 200);
+      BOOST_CHECK_EQUAL(binned_orders.aggregated_back_bets[1].amount_to_bet.value, 100);
+      BOOST_REQUIRE_EQUAL(binned_orders.aggregated_lay_bets.size(), 1u);
+      BOOST_CHECK_EQUAL(binned_orders.aggregated_lay_bets[0].amount_to_bet.value, 50);
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(search_event_names)
+{
+   try
+   {
+      CREATE_ICE_HOCKEY_BETTING_MARKET(false, 0);
+      create_event({{"en", "Chicago Blackhawks/Boston Bruins"}}, {{"en", "2016-17"}}, nhl_id);
+      generate_blocks(1);
+      const event_id_type blackhawks_vs_bruins_id = (*db.get_index_type<event_object_index>().indices().get<by_id>().rbegin()).id;
+
+      graphene::bookie::bookie_api bookie_api(app);
+
+      // the unranked search still returns every match in event id order, ignoring case
+      std::vector<event_object> events = bookie_api.get_events_containing_sub_string("CHICAGO", "en");
+      BOOST_REQUIRE_EQUAL(events.size(), 2u);
+      BOOST_CHECK(events[0].id == capitals_vs_blackhawks_id);
+      BOOST_CHECK(events[1].id == blackhawks_vs_bruins_id);
+
+      // a name starting with the query ranks above a name with a word starting with it
+      events = bookie_api.search_events("chicago", "en");
+      BOOST_REQUIRE_EQUAL(events.size(), 2u);
+      BOOST_CHECK(events[0].id == blackhawks_vs_bruins_id);
+      BOOST_CHECK(events[1].id == capitals_vs_blackhawks_id);
+
+      events = bookie_api.search_events("chicago", "en", 1, 1);
+      BOOST_REQUIRE_EQUAL(events.size(), 1u);
+      BOOST_CHECK(events[0].id == capitals_vs_blackhawks_id);
+
+      // queries shorter than a trigram and queries with no match
+      events = bookie_api.search_events("bo", "en");
+      BOOST_REQUIRE_EQUAL(events.size(), 1u);
+      BOOST_CHECK(events[0].id == blackhawks_vs_bruins_id);
+      BOOST_CHECK(bookie_api.search_events("bruins capitals", "en").empty());
+      BOOST_CHECK(bookie_api.search_events("chicago", "fr").empty());
+
+      // other languages are indexed too
+      events = bookie_api.get_events_containing_sub_string("芝加哥", "zh_Hans");
+      BOOST_REQUIRE_EQUAL(events.size(), 1u);
+      BOOST_CHECK(events[0].id == capitals_vs_blackhawks_id);
+
+      GRAPHENE_REQUIRE_THROW(bookie_api.search_events("chicago", "en", 0, 101), fc::exception);
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( peerplays_sport_create_test )
 {
    try
@@ -145,6 +145,7 @@ database_fixture::database_fixture()
       options.insert(std::make_pair("elasticsearch-node-url", boost::program_options::variable_value(string("http://localhost:9200/"), false)));
       options.insert(std::make_pair("elasticsearch-bulk-replay", boost::program_options::variable_value(uint32_t(2), false)));
       options.insert(std::make_pair("elasticsearch-bulk-sync", boost::program_options::variable_value(uint32_t(2), false)));
+      options.insert(std::make_pair("elasticsearch-flush-interval", boost::program_options::variable_value(uint32_t(100), false)));
       options.insert(std::make_pair("elasticsearch-start-es-after-block", boost::program_options::variable_value(uint32_t(0), false)));
       options.insert(std::make_pair("elasticsearch-visitor", boost::program_options::variable_value(false, false)));
       options.insert(std::make_pair("elasticsearch-operation-object", boost::program_options::variable_value(true, false)));
@@ -157,6 +158,10 @@ database_fixture::database_fixture()
    else {
       auto ahplugin = app.register_plugin<graphene::account_history::account_history_plugin>();
       app.enable_plugin("affiliate_stats");
+      if(test_name == "get_account_history_by_operations") {
+         app.enable_plugin("account_history");
+         options.insert(std::make_pair("history-by-operation-type", boost::program_options::variable_value(true, false)));
+      }
       ahplugin->plugin_set_app(&app);
       ahplugin->plugin_initialize(options);
       ahplugin->plugin_startup();
@@ -169,6 +174,7 @@ database_fixture::database_fixture()
       options.insert(std::make_pair("es-objects-elasticsearch-url", boost::program_options::variable_value(string("http://localhost:9200/"), false)));
       options.insert(std::make_pair("es-objects-bulk-replay", boost::program_options::variable_value(uint32_t(2), false)));
       options.insert(std::make_pair("es-objects-bulk-sync", boost::program_options::variable_value(uint32_t(2), false)));
+      options.insert(std::make_pair("es-objects-flush-interval", boost::program_options::variable_value(uint32_t(100), false)));
       options.insert(std::make_pair("es-objects-proposals", boost::program_options::variable_value(true, false)));
       options.insert(std::make_pair("es-objects-accounts", boost::program_options::variable_value(true, false)));
       options.insert(std::make_pair("es-objects-assets", boost::program_options::variable_value(true, false)));
@@ -180,6 +186,10 @@ database_fixture::database_fixture()
       esobjects_plugin->plugin_startup();
    }
 
+   if(test_name == "market_ticker" || test_name == "trade_history") {
+      options.insert(std::make_pair("bucket-size", boost::program_options::variable_value(string("[15,60,300,3600,86400]"), false)));
+   }
+
    mhplugin->plugin_set_app(&app);
    mhplugin->plugin_initialize(options);
    bookieplugin->plugin_set_app(&app);
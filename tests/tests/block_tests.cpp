@@ -39,6 +39,9 @@
 
 #include <fc/crypto/digest.hpp>
 
+#include <atomic>
+#include <thread>
+
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
@@ -127,6 +130,64 @@ BOOST_AUTO_TEST_CASE( block_database_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( block_database_concurrent_reads )
+{
+   try {
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+
+      block_database bdb;
+      bdb.open( data_dir.path() );
+
+      const uint32_t block_count = 3000; // more than one sync batch
+      std::vector<block_id_type> ids;
+      signed_block b;
+      for( uint32_t i = 0; i < block_count; ++i )
+      {
+         if( i > 0 ) b.previous = b.id();
+         b.witness = witness_id_type(i+1);
+         ids.push_back( b.id() );
+      }
+
+      std::atomic<uint32_t> stored{0};
+      std::atomic<bool> reader_ok{true};
+      std::thread reader( [&]() {
+         while( stored.load() < block_count )
+         {
+            uint32_t num = stored.load();
+            if( num == 0 )
+               continue;
+            auto blk = bdb.fetch_by_number( num );
+            if( !blk.valid() || blk->id() != ids[num-1] )
+               reader_ok = false;
+         }
+      });
+
+      b = signed_block();
+      for( uint32_t i = 0; i < block_count; ++i )
+      {
+         if( i > 0 ) b.previous = b.id();
+         b.witness = witness_id_type(i+1);
+         bdb.store( b.id(), b );
+         stored = i + 1;
+      }
+      reader.join();
+      BOOST_CHECK( reader_ok.load() );
+
+      bdb.remove( ids.back() );
+      BOOST_CHECK( !bdb.contains( ids.back() ) );
+      BOOST_CHECK( bdb.last_id().valid() );
+      BOOST_CHECK( *bdb.last_id() == ids[block_count-2] );
+
+      bdb.close();
+      bdb.open( data_dir.path() );
+      for( uint32_t i = 1; i < block_count; ++i )
+         BOOST_CHECK( bdb.fetch_block_id( i ) == ids[i-1] );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( generate_empty_blocks )
 {
    try {
@@ -186,6 +247,55 @@ BOOST_AUTO_TEST_CASE( generate_empty_blocks )
    }
 }
 
+BOOST_AUTO_TEST_CASE( reindex_matches_sequential_replay )
+{
+   try {
+      fc::temp_directory replay_dir( graphene::utilities::temp_directory_path() );
+      fc::temp_directory sequential_dir( graphene::utilities::temp_directory_path() );
+      auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+      const uint32_t skip = ~0;
+
+      database sequential_db;
+      sequential_db.open(sequential_dir.path(), make_genesis, "TEST");
+      {
+         database db;
+         db.open(replay_dir.path(), make_genesis, "TEST");
+         // enough blocks to go through both the apply_block and the push_block part of reindex
+         for( uint32_t i = 0; i < 120; ++i )
+         {
+            signed_transaction trx;
+            set_expiration( db, trx );
+            transfer_operation t;
+            t.to = account_id_type( 1 + i % 5 );
+            t.amount = asset( 1000 + i );
+            trx.operations.push_back( t );
+            PUSH_TX( db, trx, skip );
+
+            auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, skip);
+            PUSH_BLOCK( sequential_db, b, skip );
+         }
+         db.close();
+      }
+
+      // a different db_version wipes the object database, so everything is replayed from the block log
+      database db;
+      db.open(replay_dir.path(), make_genesis, "TEST2");
+
+      BOOST_CHECK_EQUAL( db.head_block_num(), 120u );
+      BOOST_CHECK( db.head_block_id() == sequential_db.head_block_id() );
+      BOOST_CHECK( db.head_block_time() == sequential_db.head_block_time() );
+      BOOST_CHECK_EQUAL( db.get_dynamic_global_properties().last_irreversible_block_num,
+                         sequential_db.get_dynamic_global_properties().last_irreversible_block_num );
+      for( uint32_t i = 0; i < 11; ++i )
+         BOOST_CHECK_EQUAL( db.get_balance( account_id_type(i), asset_id_type() ).amount.value,
+                            sequential_db.get_balance( account_id_type(i), asset_id_type() ).amount.value );
+      BOOST_CHECK( db.get_balance( account_id_type(3), asset_id_type() ).amount.value > 0 );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( undo_block )
 {
    try {
@@ -610,6 +720,114 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
    }
 }
 
+BOOST_AUTO_TEST_CASE( precompute_parallel )
+{
+   try {
+      fc::temp_directory dir1( graphene::utilities::temp_directory_path() ),
+                         dir2( graphene::utilities::temp_directory_path() );
+      database db1,
+               db2;
+      db1.open(dir1.path(), make_genesis, "TEST");
+      db2.open(dir2.path(), make_genesis, "TEST");
+
+      const account_object& init1 = *db1.get_index_type<account_index>().indices().get<by_name>().find("init1");
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+      public_key_type init_account_pub_key  = init_account_priv_key.get_public_key();
+
+      for( int i = 0; i < 5; ++i )
+      {
+         signed_transaction trx;
+         set_expiration( db1, trx );
+         account_create_operation cop;
+         cop.registrar = init1.id;
+         cop.name = "nathan" + fc::to_string(i);
+         cop.owner = authority(1, init_account_pub_key, 1);
+         cop.active = cop.owner;
+         trx.operations.push_back(cop);
+         trx.sign( init_account_priv_key, db1.get_chain_id() );
+         db1.push_transaction(trx);
+      }
+      auto b = db1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness( 1 ), init_account_priv_key, database::skip_nothing );
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), 5u );
+
+      signed_block received = fc::raw::unpack<signed_block>( fc::raw::pack( b ) );
+      for( const auto& trx : received.transactions )
+      {
+         BOOST_CHECK( trx.signees.empty() );
+         BOOST_CHECK( !trx.precomputed_id.valid() );
+      }
+
+      db2.precompute_parallel( received, database::skip_nothing ).wait();
+      for( const auto& trx : received.transactions )
+      {
+         BOOST_CHECK_EQUAL( trx.signees.size(), 1u );
+         BOOST_CHECK( trx.signees.count( init_account_pub_key ) );
+         BOOST_REQUIRE( trx.precomputed_id.valid() );
+         BOOST_CHECK( *trx.precomputed_id == trx.id() );
+      }
+
+      db2.push_block( received, database::skip_nothing );
+      BOOST_CHECK( db2.head_block_id() == b.id() );
+      BOOST_CHECK( db2.is_known_transaction( b.transactions[0].id() ) );
+      BOOST_CHECK( db2.get_index_type<account_index>().indices().get<by_name>().count("nathan4") );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( precheck_transactions_parallel )
+{
+   try {
+      fc::temp_directory dir( graphene::utilities::temp_directory_path() );
+      database db;
+      db.open(dir.path(), make_genesis, "TEST");
+
+      const account_object& init1 = *db.get_index_type<account_index>().indices().get<by_name>().find("init1");
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+      public_key_type init_account_pub_key  = init_account_priv_key.get_public_key();
+      // expiration is only checked once there is a head block
+      db.generate_block( db.get_slot_time(1), db.get_scheduled_witness( 1 ), init_account_priv_key, database::skip_nothing );
+
+      vector<signed_transaction> trxs;
+      for( int i = 0; i < 4; ++i )
+      {
+         signed_transaction trx;
+         set_expiration( db, trx );
+         account_create_operation cop;
+         cop.registrar = init1.id;
+         cop.name = "nathan" + fc::to_string(i);
+         cop.owner = authority(1, init_account_pub_key, 1);
+         cop.active = cop.owner;
+         trx.operations.push_back(cop);
+         trx.sign( init_account_priv_key, db.get_chain_id() );
+         trxs.push_back( fc::raw::unpack<signed_transaction>( fc::raw::pack( trx ) ) );
+      }
+      // expired
+      trxs[1].expiration = db.head_block_time() - fc::seconds(1);
+      // fails validation
+      trxs[2].operations.clear();
+
+      vector<fc::oexception> errors;
+      db.precheck_transactions_parallel( trxs, errors ).wait();
+      BOOST_REQUIRE_EQUAL( errors.size(), trxs.size() );
+      BOOST_CHECK( !errors[0] );
+      BOOST_CHECK( errors[1] );
+      BOOST_CHECK( errors[2] );
+      BOOST_CHECK( !errors[3] );
+      BOOST_CHECK_EQUAL( trxs[0].signees.size(), 1u );
+      BOOST_CHECK( trxs[0].signees.count( init_account_pub_key ) );
+
+      db.push_transaction( trxs[0] );
+      db.push_transaction( trxs[3] );
+      BOOST_CHECK( db.get_index_type<account_index>().indices().get<by_name>().count("nathan0") );
+      BOOST_CHECK( db.get_index_type<account_index>().indices().get<by_name>().count("nathan3") );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( tapos )
 {
    try {
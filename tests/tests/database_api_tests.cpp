@@ -24,10 +24,14 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <graphene/app/api.hpp>
 #include <graphene/app/database_api.hpp>
+#include <graphene/app/subscription_hub.hpp>
 
 #include "../common/database_fixture.hpp"
 
+#include <cmath>
+
 using namespace graphene::chain;
 using namespace graphene::chain::test;
 
@@ -68,4 +72,196 @@ BOOST_FIXTURE_TEST_SUITE(database_api_tests, database_fixture)
       } FC_LOG_AND_RETHROW()
   }
 
+  BOOST_AUTO_TEST_CASE(market_ticker) {
+      try {
+          ACTORS((buyer)(seller));
+          const auto &test = create_user_issued_asset("TESTCOIN");
+          const auto &core = asset_id_type()(db);
+          issue_uia(seller, test.amount(1000));
+          transfer(committee_account, buyer_id, asset(10000));
+
+          graphene::app::database_api db_api(db);
+          auto ticker = db_api.get_ticker(GRAPHENE_SYMBOL, "TESTCOIN");
+          BOOST_CHECK_EQUAL(ticker.latest, 0);
+          BOOST_CHECK_EQUAL(ticker.base_volume, 0);
+
+          create_sell_order(seller_id, test.amount(100), core.amount(200));
+          create_sell_order(buyer_id, core.amount(200), test.amount(100));
+          generate_block();
+
+          auto to_real = [](int64_t amount, uint8_t precision) { return double(amount) / pow(10, precision); };
+          ticker = db_api.get_ticker(GRAPHENE_SYMBOL, "TESTCOIN");
+          BOOST_CHECK_EQUAL(ticker.base_volume, to_real(200, core.precision));
+          BOOST_CHECK_EQUAL(ticker.quote_volume, to_real(100, test.precision));
+          const double first_price = to_real(200, core.precision) / to_real(100, test.precision);
+          BOOST_CHECK_EQUAL(ticker.latest, first_price);
+
+          // the reversed market reports the same trades
+          auto reversed = db_api.get_ticker("TESTCOIN", GRAPHENE_SYMBOL);
+          BOOST_CHECK_EQUAL(reversed.base_volume, ticker.quote_volume);
+          BOOST_CHECK_EQUAL(reversed.quote_volume, ticker.base_volume);
+          BOOST_CHECK_EQUAL(db_api.get_24_volume(GRAPHENE_SYMBOL, "TESTCOIN").base_volume, ticker.base_volume);
+
+          // trades leave the volume after 24 hours but remain the latest price
+          generate_blocks(db.head_block_time() + fc::hours(24) + fc::minutes(1));
+          set_expiration(db, trx);
+          ticker = db_api.get_ticker(GRAPHENE_SYMBOL, "TESTCOIN");
+          BOOST_CHECK_EQUAL(ticker.base_volume, 0);
+          BOOST_CHECK_EQUAL(ticker.quote_volume, 0);
+          BOOST_CHECK_EQUAL(ticker.latest, first_price);
+
+          create_sell_order(seller_id, test.amount(100), core.amount(300));
+          create_sell_order(buyer_id, core.amount(300), test.amount(100));
+          generate_block();
+          ticker = db_api.get_ticker(GRAPHENE_SYMBOL, "TESTCOIN");
+          BOOST_CHECK_EQUAL(ticker.base_volume, to_real(300, core.precision));
+          BOOST_CHECK_CLOSE(ticker.percent_change, 50, 0.0001);
+      } FC_LOG_AND_RETHROW()
+  }
+
+  BOOST_AUTO_TEST_CASE(trade_history) {
+      try {
+          ACTORS((buyer)(seller));
+          const auto &test = create_user_issued_asset("TESTCOIN");
+          const auto &core = asset_id_type()(db);
+          issue_uia(seller, test.amount(1000));
+          transfer(committee_account, buyer_id, asset(10000));
+
+          vector<fc::time_point_sec> fill_times;
+          for (int i = 1; i <= 3; ++i) {
+              create_sell_order(seller_id, test.amount(100), core.amount(100 * i));
+              create_sell_order(buyer_id, core.amount(100 * i), test.amount(100));
+              generate_block();
+              fill_times.push_back(db.head_block_time());
+              generate_blocks(db.head_block_time() + fc::hours(1));
+              set_expiration(db, trx);
+          }
+
+          graphene::app::database_api db_api(db);
+
+          // the order history keeps both sides of every match
+          BOOST_CHECK_EQUAL(db.get_index_type<graphene::market_history::history_index>().indices().size(), 6u);
+
+          // each match is returned once, newest first
+          auto trades = db_api.get_trade_history(GRAPHENE_SYMBOL, "TESTCOIN", fc::time_point_sec(), fc::time_point_sec(), 100);
+          BOOST_REQUIRE_EQUAL(trades.size(), 3u);
+          BOOST_CHECK(trades[0].date == fill_times[2]);
+          BOOST_CHECK(trades[2].date == fill_times[0]);
+          BOOST_CHECK_EQUAL(trades[0].value, double(300) / pow(10, core.precision));
+          BOOST_CHECK_EQUAL(trades[0].amount, double(100) / pow(10, test.precision));
+          BOOST_CHECK_GT(trades[0].sequence, trades[1].sequence);
+          BOOST_CHECK_GT(trades[1].sequence, trades[2].sequence);
+
+          // the reversed market reports the same trades with amount and value exchanged
+          auto reversed = db_api.get_trade_history("TESTCOIN", GRAPHENE_SYMBOL, fc::time_point_sec(), fc::time_point_sec(), 100);
+          BOOST_REQUIRE_EQUAL(reversed.size(), 3u);
+          BOOST_CHECK_EQUAL(reversed[0].amount, trades[0].value);
+          BOOST_CHECK_EQUAL(reversed[0].value, trades[0].amount);
+
+          // start is exclusive, stop is inclusive
+          trades = db_api.get_trade_history(GRAPHENE_SYMBOL, "TESTCOIN", fill_times[2], fill_times[1], 100);
+          BOOST_REQUIRE_EQUAL(trades.size(), 1u);
+          BOOST_CHECK(trades[0].date == fill_times[1]);
+
+          trades = db_api.get_trade_history(GRAPHENE_SYMBOL, "TESTCOIN", fc::time_point_sec(), fc::time_point_sec(), 2);
+          BOOST_REQUIRE_EQUAL(trades.size(), 2u);
+
+          // page through the rest by sequence
+          auto next = db_api.get_trade_history_by_sequence(GRAPHENE_SYMBOL, "TESTCOIN", trades[1].sequence - 1, fc::time_point_sec(), 100);
+          BOOST_REQUIRE_EQUAL(next.size(), 1u);
+          BOOST_CHECK(next[0].date == fill_times[0]);
+
+          next = db_api.get_trade_history_by_sequence(GRAPHENE_SYMBOL, "TESTCOIN", trades[0].sequence, fill_times[1], 100);
+          BOOST_REQUIRE_EQUAL(next.size(), 2u);
+          BOOST_CHECK_EQUAL(next[0].sequence, trades[0].sequence);
+          BOOST_CHECK_EQUAL(next[1].sequence, trades[1].sequence);
+      } FC_LOG_AND_RETHROW()
+  }
+
+  BOOST_AUTO_TEST_CASE(asset_holders) {
+      try {
+          ACTORS((alice)(bob)(carol));
+          const auto &test = create_user_issued_asset("TESTCOIN");
+          const asset_id_type test_id = test.id;
+          issue_uia(alice, test.amount(300));
+          issue_uia(bob, test.amount(200));
+          issue_uia(carol, test.amount(100));
+          generate_block();
+
+          graphene::app::asset_api asset_api(app);
+          BOOST_CHECK_EQUAL(asset_api.get_asset_holders_count("TESTCOIN"), 3);
+
+          // holders are ranked by balance and paged by rank
+          auto holders = asset_api.get_asset_holders("TESTCOIN", 0, 2);
+          BOOST_REQUIRE_EQUAL(holders.size(), 2u);
+          BOOST_CHECK_EQUAL(holders[0].name, "alice");
+          BOOST_CHECK_EQUAL(holders[1].name, "bob");
+          holders = asset_api.get_asset_holders("TESTCOIN", 2, 2);
+          BOOST_REQUIRE_EQUAL(holders.size(), 1u);
+          BOOST_CHECK_EQUAL(holders[0].name, "carol");
+          BOOST_CHECK_EQUAL(holders[0].amount, 100);
+          BOOST_CHECK(asset_api.get_asset_holders("TESTCOIN", 3, 2).empty());
+
+          // accounts whose balance drops to zero are no longer holders
+          transfer(carol_id, alice_id, test.amount(100));
+          generate_block();
+          BOOST_CHECK_EQUAL(asset_api.get_asset_holders_count("TESTCOIN"), 2);
+          holders = asset_api.get_asset_holders("TESTCOIN", 0, 100);
+          BOOST_REQUIRE_EQUAL(holders.size(), 2u);
+          BOOST_CHECK_EQUAL(holders[0].amount, 400);
+
+          bool found = false;
+          for (const auto &ah : asset_api.get_all_asset_holders()) {
+              if (ah.asset_id == test_id) {
+                  BOOST_CHECK_EQUAL(ah.count, 2);
+                  found = true;
+              }
+          }
+          BOOST_CHECK(found);
+      } FC_LOG_AND_RETHROW()
+  }
+
+  BOOST_AUTO_TEST_CASE(subscription_hub_shares_updates) {
+      try {
+          ACTORS((alice)(bob));
+          generate_block();
+
+          auto hub = app.get_subscription_hub();
+          const size_t subscribers = hub->subscriber_count();
+
+          vector<fc::variant> alice_updates;
+          vector<fc::variant> bob_updates;
+          {
+              graphene::app::database_api alice_api(db, &app);
+              graphene::app::database_api bob_api(db, &app);
+              BOOST_CHECK_EQUAL(hub->subscriber_count(), subscribers + 2);
+
+              alice_api.set_subscribe_callback([&alice_updates](const fc::variant &v) { alice_updates.push_back(v); }, false);
+              bob_api.set_subscribe_callback([&bob_updates](const fc::variant &v) { bob_updates.push_back(v); }, false);
+              alice_api.get_full_accounts({"alice"}, true);
+              bob_api.get_full_accounts({"alice", "bob"}, true);
+
+              transfer(committee_account, alice_id, asset(1000));
+              generate_block();
+              fc::usleep(fc::milliseconds(200));
+
+              // both connections are told about the balance of alice
+              auto has_alice_balance = [&](const vector<fc::variant> &notifications) {
+                  for (const auto &notification : notifications)
+                      for (const auto &update : notification.get_array())
+                          if (update.is_object() && update.get_object().contains("owner") && update.get_object().contains("balance") &&
+                              update["owner"].as<account_id_type>(1) == alice_id)
+                              return true;
+                  return false;
+              };
+              BOOST_CHECK(has_alice_balance(alice_updates));
+              BOOST_CHECK(has_alice_balance(bob_updates));
+          }
+
+          // destroyed connections are dropped from the hub
+          generate_block();
+          BOOST_CHECK_EQUAL(hub->subscriber_count(), subscribers);
+      } FC_LOG_AND_RETHROW()
+  }
+
 BOOST_AUTO_TEST_SUITE_END()
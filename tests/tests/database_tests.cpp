@@ -27,8 +27,15 @@
 #include <graphene/chain/database.hpp>
 
 #include <graphene/chain/account_object.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/filesystem.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <thread>
 
 #include "../common/database_fixture.hpp"
 
@@ -81,6 +88,46 @@ BOOST_AUTO_TEST_CASE( merge_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( undo_reuses_saved_objects_test )
+{
+   try {
+      database db;
+      account_balance_id_type bal_id;
+      {
+         auto ses = db._undo_db.start_undo_session();
+         bal_id = db.create<account_balance_object>( [&]( account_balance_object& obj ){
+             obj.balance = 1;
+         }).id;
+         ses.merge();
+      }
+
+      // saved copies of discarded states are reused, they must not leak values between sessions
+      for( int i = 0; i < 3; ++i )
+      {
+         auto ses = db._undo_db.start_undo_session();
+         db.modify( bal_id(db), [&]( account_balance_object& obj ){
+             obj.balance = 100 + i;
+             obj.owner = account_id_type( 5 + i );
+         });
+         ses.undo();
+         BOOST_CHECK_EQUAL( bal_id(db).balance.value, 1 );
+         BOOST_CHECK( bal_id(db).owner == account_id_type() );
+      }
+
+      {
+         auto ses = db._undo_db.start_undo_session();
+         db.modify( bal_id(db), [&]( account_balance_object& obj ){ obj.balance = 7; });
+         db.remove( bal_id(db) );
+         ses.undo();
+      }
+      BOOST_CHECK_EQUAL( bal_id(db).balance.value, 1 );
+   } catch ( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( flat_index_test )
 {
    ACTORS((sam));
@@ -195,4 +242,107 @@ BOOST_AUTO_TEST_CASE( direct_index_test )
    // but the secondary has not updated its representation
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( binary_snapshot_roundtrip )
+{ try {
+   ACTORS( (alice)(bob) );
+   generate_block();
+
+   fc::temp_directory tempdir( graphene::utilities::temp_directory_path() );
+   const fc::path snapshot = tempdir.path() / "snapshot.bin";
+   db.save_snapshot( snapshot );
+
+   database restored;
+   restored.load_snapshot( snapshot );
+
+   const auto& orig_accounts = db.get_index_type<account_index>();
+   const auto& new_accounts = restored.get_index_type<account_index>();
+   BOOST_CHECK( orig_accounts.get_next_id() == new_accounts.get_next_id() );
+   BOOST_CHECK_EQUAL( orig_accounts.indices().size(), new_accounts.indices().size() );
+   BOOST_CHECK( orig_accounts.hash() == new_accounts.hash() );
+   BOOST_CHECK( db.get_index_type<asset_index>().hash() == restored.get_index_type<asset_index>().hash() );
+
+   // secondary lookups must be rebuilt as well
+   const auto& names = new_accounts.indices().get<by_name>();
+   BOOST_REQUIRE( names.find( "alice" ) != names.end() );
+   BOOST_CHECK( names.find( "alice" )->id == alice_id );
+   BOOST_CHECK( restored.get( bob_id ).name == "bob" );
+   BOOST_CHECK( restored.get( dynamic_global_property_id_type() ).head_block_number == db.head_block_num() );
+
+   // a damaged section must be rejected
+   {
+      std::fstream f( snapshot.generic_string(), std::ios::in | std::ios::out | std::ios::binary );
+      char c;
+      f.seekg( -1, std::ios::end );
+      f.get( c );
+      f.seekp( -1, std::ios::end );
+      f.put( c ^ 0x55 );
+   }
+   database corrupted;
+   GRAPHENE_REQUIRE_THROW( corrupted.load_snapshot( snapshot ), fc::exception );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( block_profiling )
+{ try {
+   BOOST_CHECK( !db.get_block_profile().valid() );
+   db.enable_block_profiling( true );
+
+   ACTORS( (alice) );
+   transfer( account_id_type(), alice_id, asset( 1000 ) );
+   generate_block();
+   generate_block();
+
+   auto profile = db.get_block_profile( true );
+   BOOST_REQUIRE( profile.valid() );
+   BOOST_CHECK_EQUAL( profile->blocks.count, 2u );
+   BOOST_CHECK_EQUAL( profile->last_block, db.head_block_num() );
+   BOOST_CHECK_EQUAL( profile->phases["apply_transactions"].count, 2u );
+   BOOST_CHECK_EQUAL( profile->phases["clear_expired_orders"].count, 2u );
+   // operations are only counted when applied in a block, not when pushed to the pending state
+   BOOST_CHECK_EQUAL( profile->operations["account_create_operation"].count, 1u );
+   BOOST_CHECK_EQUAL( profile->operations["transfer_operation"].count, 1u );
+   BOOST_CHECK( profile->objects["1.2"].created >= 1 );
+   BOOST_CHECK( profile->undo_state_sizes.count > 0 );
+   BOOST_CHECK_EQUAL( profile->blocks.buckets.size(), profile_histogram::bucket_count );
+
+   // the profile was reset
+   profile = db.get_block_profile();
+   BOOST_REQUIRE( profile.valid() );
+   BOOST_CHECK_EQUAL( profile->blocks.count, 0u );
+
+   db.enable_block_profiling( false );
+   BOOST_CHECK( !db.get_block_profile().valid() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( read_lock_excludes_chain_updates )
+{ try {
+   ACTORS( (alice)(bob) );
+   const share_type total = 1000000;
+   transfer( committee_account, alice_id, asset( total ) );
+   generate_block();
+
+   // balances of a transfer are adjusted one after the other, a reader holding the lock never sees the middle
+   std::atomic<bool> done{ false };
+   std::atomic<bool> consistent{ true };
+   std::thread reader( [&]() {
+      while( !done )
+      {
+         db.with_read_lock( [&]() {
+            if( db.get_balance( alice_id, asset_id_type() ).amount + db.get_balance( bob_id, asset_id_type() ).amount != total )
+               consistent = false;
+         });
+      }
+   });
+
+   for( int i = 0; i < 20; ++i )
+   {
+      transfer( alice_id, bob_id, asset( 100 ) );
+      transfer( bob_id, alice_id, asset( 50 ) );
+      generate_block();
+   }
+   done = true;
+   reader.join();
+   BOOST_CHECK( consistent );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 20 * 50 );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
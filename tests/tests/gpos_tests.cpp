@@ -239,6 +239,64 @@ BOOST_AUTO_TEST_CASE(gpos_vesting_type)
    }
 }
 
+BOOST_AUTO_TEST_CASE( gpos_vesting_stake_index )
+{
+   ACTORS((alice)(bob));
+   try
+   {
+      const auto& core = asset_id_type()(db);
+      transfer( committee_account, alice_id, core.amount( 1000 ) );
+      transfer( committee_account, bob_id, core.amount( 1000 ) );
+
+      generate_blocks( HARDFORK_GPOS_TIME );
+      generate_block();
+
+      const auto& stake_idx = db.get_index_type< primary_index< vesting_balance_index > >()
+                                .get_secondary_index< vesting_balance_stake_index >();
+      const auto& gpos_stakes = stake_idx.get_core_stakes( vesting_balance_type::gpos );
+
+      // the incremental totals must always match a full scan of the vesting balances
+      auto check_totals = [&]() {
+         std::map<account_id_type, share_type> expected;
+         for( const auto& vbo : db.get_index_type<vesting_balance_index>().indices() )
+            if( vbo.balance.asset_id == asset_id_type() && vbo.balance_type == vesting_balance_type::gpos )
+               expected[vbo.owner] += vbo.balance.amount;
+         BOOST_REQUIRE_EQUAL( gpos_stakes.size(), expected.size() );
+         for( const auto& e : expected )
+         {
+            auto itr = gpos_stakes.find( e.first );
+            BOOST_REQUIRE( itr != gpos_stakes.end() );
+            BOOST_CHECK_EQUAL( itr->second.amount.value, e.second.value );
+         }
+      };
+
+      check_totals();
+      create_vesting( alice_id, core.amount( 100 ), vesting_balance_type::gpos );
+      create_vesting( alice_id, core.amount( 50 ), vesting_balance_type::gpos );
+      create_vesting( bob_id, core.amount( 200 ), vesting_balance_type::gpos );
+      create_vesting( bob_id, core.amount( 300 ), vesting_balance_type::normal );
+      check_totals();
+      BOOST_CHECK_EQUAL( gpos_stakes.at( alice_id ).amount.value, 150 );
+      BOOST_CHECK_EQUAL( gpos_stakes.at( alice_id ).balance_count, 2u );
+      BOOST_CHECK_EQUAL( gpos_stakes.at( bob_id ).amount.value, 200 );
+
+      // popping the block that created a balance removes it from the totals again
+      generate_block();
+      create_vesting( bob_id, core.amount( 25 ), vesting_balance_type::gpos );
+      generate_block();
+      BOOST_CHECK_EQUAL( gpos_stakes.at( bob_id ).amount.value, 225 );
+      db.pop_block();
+      db.clear_pending();
+      BOOST_CHECK_EQUAL( gpos_stakes.at( bob_id ).amount.value, 200 );
+      check_totals();
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( dividends )
 {
    ACTORS((alice)(bob));
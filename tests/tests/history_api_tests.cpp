@@ -26,6 +26,7 @@
 
 #include <graphene/app/database_api.hpp>
 #include <graphene/app/api.hpp>
+#include <graphene/account_history/account_history_plugin.hpp>
 #include <graphene/chain/account_object.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -602,4 +603,66 @@ BOOST_AUTO_TEST_CASE(get_account_history_operations) {
    }
 }
 
+BOOST_AUTO_TEST_CASE(get_account_history_by_operations) {
+   try {
+      graphene::app::history_api hist_api(app);
+      auto ah = app.get_plugin<graphene::account_history::account_history_plugin>("account_history");
+      BOOST_REQUIRE(ah && ah->operation_type_index() != nullptr);
+
+      int asset_create_op_id = operation::tag<asset_create_operation>::value;
+      int account_create_op_id = operation::tag<account_create_operation>::value;
+      int transfer_op_id = operation::tag<transfer_operation>::value;
+
+      flat_set<int> operation_types;
+      operation_types.insert(asset_create_op_id);
+      operation_types.insert(account_create_op_id);
+      vector<operation_history_object> histories = hist_api.get_account_history_by_operations("committee-account", operation_types, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_CHECK_EQUAL(histories.size(), 0u);
+
+      create_bitasset("CNY", account_id_type());
+      create_account("sam");
+      create_account("alice");
+      generate_block();
+
+      // both types are merged, most recent first
+      histories = hist_api.get_account_history_by_operations("committee-account", operation_types, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_REQUIRE_EQUAL(histories.size(), 3u);
+      BOOST_CHECK_EQUAL(histories[0].op.which(), account_create_op_id);
+      BOOST_CHECK_EQUAL(histories[1].op.which(), account_create_op_id);
+      BOOST_CHECK_EQUAL(histories[2].op.which(), asset_create_op_id);
+      BOOST_CHECK_EQUAL(histories[2].id.instance(), 0u);
+      BOOST_CHECK(histories[0].id.instance() > histories[1].id.instance());
+
+      // start, stop and limit
+      histories = hist_api.get_account_history_by_operations("committee-account", operation_types, operation_history_id_type(1), operation_history_id_type(), 100);
+      BOOST_REQUIRE_EQUAL(histories.size(), 2u);
+      BOOST_CHECK_EQUAL(histories[0].id.instance(), 1u);
+      histories = hist_api.get_account_history_by_operations("committee-account", operation_types, operation_history_id_type(), operation_history_id_type(1), 100);
+      BOOST_CHECK_EQUAL(histories.size(), 1u);
+      histories = hist_api.get_account_history_by_operations("committee-account", operation_types, operation_history_id_type(), operation_history_id_type(), 1);
+      BOOST_CHECK_EQUAL(histories.size(), 1u);
+
+      // the single type query uses the same index
+      histories = hist_api.get_account_history_operations("committee-account", asset_create_op_id, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_REQUIRE_EQUAL(histories.size(), 1u);
+      BOOST_CHECK_EQUAL(histories[0].id.instance(), 0u);
+
+      // entries follow popped blocks
+      const account_id_type alice_id = get_account("alice").id;
+      transfer(account_id_type(), alice_id, asset(1000));
+      generate_block();
+      histories = hist_api.get_account_history_operations("alice", transfer_op_id, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_CHECK_EQUAL(histories.size(), 1u);
+      db.pop_block();
+      histories = hist_api.get_account_history_operations("alice", transfer_op_id, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_CHECK_EQUAL(histories.size(), 0u);
+      histories = hist_api.get_account_history_operations("alice", account_create_op_id, operation_history_id_type(), operation_history_id_type(), 100);
+      BOOST_CHECK_EQUAL(histories.size(), 1u);
+
+   } catch (fc::exception &e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
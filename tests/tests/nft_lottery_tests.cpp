@@ -160,6 +160,54 @@ BOOST_AUTO_TEST_CASE(tickets_purchase_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(tickets_supply_index_test)
+{
+    try
+    {
+        nft_metadata_id_type test_nft_md_id = db.get_index<nft_metadata_object>().get_next_id();
+        INVOKE(create_lottery_nft_md_test);
+        auto &test_nft_md_obj = test_nft_md_id(db);
+        const auto &idx_by_md = db.get_index_type<nft_index>().indices().get<by_metadata>();
+        auto counted_supply = [&]() {
+            auto range = idx_by_md.equal_range(test_nft_md_id);
+            return share_type(std::distance(range.first, range.second));
+        };
+
+        nft_lottery_token_purchase_operation tpo;
+        tpo.fee = asset();
+        tpo.buyer = account_id_type();
+        tpo.lottery_id = test_nft_md_obj.id;
+        tpo.tickets_to_buy = 3;
+        tpo.amount = asset(300);
+        trx.operations.push_back(tpo);
+        set_expiration(db, trx);
+        PUSH_TX(db, trx, ~0);
+        trx.operations.clear();
+        generate_block();
+        BOOST_CHECK(test_nft_md_obj.get_token_current_supply(db) == 3);
+        BOOST_CHECK(test_nft_md_obj.get_token_current_supply(db) == counted_supply());
+
+        tpo.tickets_to_buy = 2;
+        tpo.amount = asset(200);
+        trx.operations.push_back(tpo);
+        set_expiration(db, trx);
+        PUSH_TX(db, trx, ~0);
+        trx.operations.clear();
+        generate_block();
+        BOOST_CHECK(test_nft_md_obj.get_token_current_supply(db) == 5);
+
+        // undoing the block must restore the counter
+        db.pop_block();
+        BOOST_CHECK(test_nft_md_obj.get_token_current_supply(db) == 3);
+        BOOST_CHECK(test_nft_md_obj.get_token_current_supply(db) == counted_supply());
+    }
+    catch (fc::exception &e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
 BOOST_AUTO_TEST_CASE(tickets_purchase_fail_test)
 {
     try
@@ -1253,6 +1253,22 @@ BOOST_AUTO_TEST_CASE(transfer_with_memo) {
       auto memo = db.get_recent_transaction(trx.id()).operations.front().get<transfer_operation>().memo;
       BOOST_CHECK(memo);
       BOOST_CHECK_EQUAL(memo->get_message(bob_private_key, alice_public_key), "Dear Bob,\n\nMoney!\n\nLove, Alice");
+
+      // a second transaction in the same block is kept apart from the first
+      signed_transaction trx2;
+      set_expiration(db, trx2);
+      op.amount = asset(100);
+      op.memo.reset();
+      trx2.operations = {op};
+      trx2.sign(alice_private_key, db.get_chain_id());
+      db.push_transaction(trx2);
+
+      // the body is still available once the transaction is included in a block
+      generate_block();
+      memo = db.get_recent_transaction(trx.id()).operations.front().get<transfer_operation>().memo;
+      BOOST_CHECK(memo);
+      BOOST_CHECK_EQUAL(memo->get_message(bob_private_key, alice_public_key), "Dear Bob,\n\nMoney!\n\nLove, Alice");
+      BOOST_CHECK(db.get_recent_transaction(trx2.id()).id() == trx2.id());
    } FC_LOG_AND_RETHROW()
 }
 
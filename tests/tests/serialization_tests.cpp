@@ -25,6 +25,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <graphene/chain/database.hpp>
+#include <graphene/net/core_messages.hpp>
+#include <graphene/net/message.hpp>
 
 
 #include <fc/crypto/digest.hpp>
@@ -55,6 +57,50 @@ BOOST_AUTO_TEST_CASE( serialization_raw_test )
       throw;
    }
 }
+BOOST_AUTO_TEST_CASE( compact_block_message_test )
+{
+   try {
+      transfer_operation op;
+      op.from = account_id_type(1);
+      op.to = account_id_type(2);
+      op.amount = asset(100);
+      trx.operations.push_back( op );
+      trx.set_expiration( db.head_block_time() + fc::minutes(1) );
+
+      signed_block block;
+      block.previous = db.head_block_id();
+      block.timestamp = db.head_block_time() + fc::seconds(5);
+      processed_transaction ptrx( trx );
+      ptrx.operation_results.push_back( void_result() );
+      block.transactions.push_back( ptrx );
+      block.transaction_merkle_root = block.calculate_merkle_root();
+
+      // a transaction is referenced by the id of the trx_message it was relayed in
+      graphene::net::message transaction_message( graphene::net::trx_message( trx ) );
+      BOOST_CHECK( graphene::net::get_trx_message_id( ptrx ) == transaction_message.id() );
+
+      graphene::net::item_hash_t item_hash = graphene::net::message( graphene::net::block_message( block ) ).id();
+      graphene::net::compact_block_message compact( item_hash, block );
+      auto unpacked = graphene::net::message( compact ).as<graphene::net::compact_block_message>();
+      BOOST_CHECK( unpacked.item_hash == item_hash );
+      BOOST_CHECK( unpacked.header.id() == block.id() );
+      BOOST_REQUIRE_EQUAL( unpacked.transactions.size(), 1u );
+      BOOST_CHECK( unpacked.transactions[0].message_id == transaction_message.id() );
+      BOOST_CHECK_EQUAL( unpacked.transactions[0].operation_results.size(), 1u );
+
+      // rebuilding from the relayed transaction gives back the same block message
+      signed_block rebuilt;
+      static_cast<signed_block_header&>(rebuilt) = unpacked.header;
+      processed_transaction rebuilt_trx( transaction_message.as<graphene::net::trx_message>().trx );
+      rebuilt_trx.operation_results = unpacked.transactions[0].operation_results;
+      rebuilt.transactions.push_back( rebuilt_trx );
+      BOOST_CHECK( rebuilt.calculate_merkle_root() == block.transaction_merkle_root );
+      BOOST_CHECK( graphene::net::message( graphene::net::block_message( rebuilt ) ).id() == item_hash );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
 BOOST_AUTO_TEST_CASE( serialization_json_test )
 {
    try {
@@ -68,6 +68,51 @@ BOOST_AUTO_TEST_CASE(last_voting_date)
 
    } FC_LOG_AND_RETHROW()
 }
+BOOST_AUTO_TEST_CASE(voters_by_id_index)
+{
+   try
+   {
+      ACTORS((alice)(bob));
+
+      graphene::app::database_api db_api1(db);
+      const auto witness1_vote = witness_id_type(1)(db).vote_id;
+      const auto witness2_vote = witness_id_type(2)(db).vote_id;
+      BOOST_CHECK(db_api1.get_voters_by_id(witness1_vote).empty());
+
+      auto vote = [&](const account_object& acct, const fc::ecc::private_key& key, flat_set<vote_id_type> votes) {
+         graphene::chain::account_update_operation op;
+         op.account = acct.id;
+         op.new_options = acct.options;
+         op.new_options->votes = votes;
+         trx.operations.push_back(op);
+         sign(trx, key);
+         PUSH_TX( db, trx, ~0 );
+         trx.clear();
+      };
+
+      vote(alice, alice_private_key, {witness1_vote});
+      vote(bob, bob_private_key, {witness1_vote, witness2_vote});
+
+      auto voters = db_api1.get_voters_by_id(witness1_vote);
+      BOOST_REQUIRE_EQUAL(voters.size(), 2);
+      BOOST_CHECK(voters[0].id == alice_id);
+      BOOST_CHECK(voters[1].id == bob_id);
+      BOOST_CHECK_EQUAL(db_api1.get_voters_by_id(witness2_vote).size(), 1);
+
+      // changing votes moves the account between entries
+      vote(alice_id(db), alice_private_key, {witness2_vote});
+      voters = db_api1.get_voters_by_id(witness1_vote);
+      BOOST_REQUIRE_EQUAL(voters.size(), 1);
+      BOOST_CHECK(voters[0].id == bob_id);
+      BOOST_CHECK_EQUAL(db_api1.get_voters_by_id(witness2_vote).size(), 2);
+
+      vote(bob_id(db), bob_private_key, {});
+      BOOST_CHECK(db_api1.get_voters_by_id(witness1_vote).empty());
+      BOOST_CHECK_EQUAL(db_api1.get_voters_by_id(witness2_vote).size(), 1);
+
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE(last_voting_date_proxy)
 {
    try